@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "action_queue.hpp"
+
+#include "line_profile.hpp"
+#include "loop_lag.hpp"
+#include "ratelimit.hpp"
+
+#include <CLI/CLI.hpp>
+#include <boost/asio/post.hpp>
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+std::optional<ActionQueue::Overflow>
+    ActionQueue::parseOverflow(const std::string& name)
+{
+    if (name == "drop-oldest")
+    {
+        return Overflow::dropOldest;
+    }
+    if (name == "merge-target")
+    {
+        return Overflow::mergeTarget;
+    }
+    if (name == "latest-per-line")
+    {
+        return Overflow::latestPerLine;
+    }
+    return std::nullopt;
+}
+
+void ActionQueue::addOptions(CLI::App& app, Config& config)
+{
+    app.add_option("--action-queue-size", config.capacity,
+                   "Actions of edges queued at most, 0 runs them directly");
+    app.add_option_function<std::string>(
+           "--action-overflow",
+           [&config](const std::string& name) {
+               config.overflow = *parseOverflow(name);
+           },
+           "Full action queue policy: drop-oldest, merge-target or "
+           "latest-per-line")
+        ->check(CLI::Validator(
+            [](std::string& name) {
+                return parseOverflow(name) ? std::string()
+                                           : "unknown policy " + name;
+            },
+            "POLICY"));
+}
+
+void ActionQueue::push(const std::string& line, uint32_t profileId,
+                       const std::string& target, Action&& action)
+{
+    if (config.capacity == 0)
+    {
+        action(true);
+        return;
+    }
+
+    if (queue.size() >= config.capacity &&
+        !makeRoom(line, profileId, target, action))
+    {
+        return;
+    }
+
+    queue.push_back(Entry{line, profileId, target, std::move(action)});
+    maxDepth = std::max(maxDepth, queue.size());
+    scheduleRun();
+}
+
+void ActionQueue::replace(const std::string& line, uint32_t profileId,
+                          const std::string& target, Action&& action)
+{
+    auto it = std::find_if(queue.begin(), queue.end(), [&](auto& entry) {
+        return entry.target == target;
+    });
+    if (it == queue.end())
+    {
+        push(line, profileId, target, std::move(action));
+        return;
+    }
+
+    mergedCount++;
+    it->action(false);
+    it->line = line;
+    it->profileId = profileId;
+    it->action = std::move(action);
+}
+
+bool ActionQueue::makeRoom(const std::string& line, uint32_t profileId,
+                           const std::string& target, Action& action)
+{
+    if (config.overflow == Overflow::mergeTarget)
+    {
+        auto it = std::find_if(queue.begin(), queue.end(), [&](auto& entry) {
+            return entry.target == target;
+        });
+        if (it != queue.end())
+        {
+            /* The queued action does the same */
+            mergedCount++;
+            action(false);
+            return false;
+        }
+    }
+    else if (config.overflow == Overflow::latestPerLine)
+    {
+        auto it = std::find_if(queue.begin(), queue.end(), [&](auto& entry) {
+            return entry.line == line;
+        });
+        if (it != queue.end())
+        {
+            /* The new action carries the latest state of the line */
+            mergedCount++;
+            it->action(false);
+            it->profileId = profileId;
+            it->target = target;
+            it->action = std::move(action);
+            return false;
+        }
+    }
+
+    auto oldest = std::move(queue.front());
+    queue.pop_front();
+    droppedCount++;
+
+    ratelimit::warning(ratelimit::get(oldest.line),
+                       "Action queue full, dropped {TARGET} of {GPIO}",
+                       "TARGET", oldest.target, "GPIO", oldest.line);
+    oldest.action(false);
+
+    return true;
+}
+
+void ActionQueue::scheduleRun()
+{
+    if (scheduled)
+    {
+        return;
+    }
+    scheduled = true;
+
+    boost::asio::post(io, [this]() {
+        scheduled = false;
+        if (queue.empty())
+        {
+            return;
+        }
+
+        auto entry = std::move(queue.front());
+        queue.pop_front();
+        if (!queue.empty())
+        {
+            scheduleRun();
+        }
+
+        looplag::Scope scope("queued action", entry.line);
+        profile::Handler cost(entry.profileId);
+        entry.action(true);
+    });
+}
+
+std::shared_ptr<sdbusplus::asio::dbus_interface>
+    ActionQueue::publish(sdbusplus::asio::object_server& server,
+                         const std::string& path)
+{
+    /* Read on demand without change signals, the counters change with
+     * every edge */
+    constexpr uint64_t flags = 0;
+
+    auto iface = server.add_interface(path, actionQueueInterface);
+    iface->register_property_r("Depth", uint64_t(0), flags,
+                               [this](const auto&) {
+                                   return static_cast<uint64_t>(depth());
+                               });
+    iface->register_property_r("HighWater", uint64_t(0), flags,
+                               [this](const auto&) {
+                                   return static_cast<uint64_t>(highWater());
+                               });
+    iface->register_property_r("Dropped", uint64_t(0), flags,
+                               [this](const auto&) { return dropped(); });
+    iface->register_property_r("Merged", uint64_t(0), flags,
+                               [this](const auto&) { return merged(); });
+    iface->initialize();
+
+    return iface;
+}
+
+} // namespace gpio
+} // namespace phosphor
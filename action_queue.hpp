@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <sdbusplus/asio/object_server.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace CLI
+{
+class App;
+}
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @brief Interface holding the action queue counters */
+constexpr auto actionQueueInterface = "xyz.openbmc_project.GPIO.ActionQueue";
+
+/** @class ActionQueue
+ *  @brief Bounded queue of the actions started by edges, such as unit
+ *  starts or inventory updates.
+ *
+ *  Actions run one per event loop turn, so the edges of other lines are
+ *  read in between. A run is charged to the profile of its line and timed
+ *  as a handler of the event loop. An action still blocks the loop while it runs, the
+ *  queue only bounds the backlog: when it is full, the overflow policy
+ *  makes room for a new action, so a slow systemd or inventory manager
+ *  drops actions instead of piling them up.
+ */
+class ActionQueue
+{
+  public:
+    /** @brief Called with true to run the action, with false when it was
+     *         dropped or merged into another one
+     */
+    using Action = std::function<void(bool run)>;
+
+    /** @brief What a full queue does with a new action */
+    enum class Overflow
+    {
+        /** @brief Drop the oldest action */
+        dropOldest,
+        /** @brief Merge the action into a queued one of the same target,
+         *         or drop the oldest one */
+        mergeTarget,
+        /** @brief Replace a queued action of the same line, or drop the
+         *         oldest one */
+        latestPerLine,
+    };
+
+    struct Config
+    {
+        /** @brief Queued actions, 0 runs them directly */
+        size_t capacity = 64;
+        Overflow overflow = Overflow::dropOldest;
+    };
+
+    /** @brief Parses "drop-oldest", "merge-target" or "latest-per-line" */
+    static std::optional<Overflow> parseOverflow(const std::string& name);
+
+    /** @brief Adds the queue size and overflow policy options
+     *
+     *  @param[in] app    - command line parser of main()
+     *  @param[in] config - settings set by the options
+     */
+    static void addOptions(CLI::App& app, Config& config);
+
+    ActionQueue() = delete;
+    ~ActionQueue() = default;
+    ActionQueue(const ActionQueue&) = delete;
+    ActionQueue& operator=(const ActionQueue&) = delete;
+    ActionQueue(ActionQueue&&) = delete;
+    ActionQueue& operator=(ActionQueue&&) = delete;
+
+    /** @brief Constructs ActionQueue object.
+     *
+     *  @param[in] io     - io service running the actions
+     *  @param[in] config - capacity and overflow policy
+     */
+    ActionQueue(boost::asio::io_context& io, const Config& config) :
+        io(io), config(config)
+    {}
+
+    /** @brief Queues an action
+     *
+     *  @param[in] line      - GPIO line message of the edge
+     *  @param[in] profileId - profile id of the line, charged with the run
+     *  @param[in] target    - what the action acts on, actions with the
+     *                         same target can be merged
+     *  @param[in] action    - the action, it must not refer to the line
+     *                         object, which may be gone when it runs
+     */
+    void push(const std::string& line, uint32_t profileId,
+              const std::string& target, Action&& action);
+
+    /** @brief Queues an action superseding the queued one of the same
+     *         target whatever the overflow policy, for actions setting a
+     *         state where only the latest matters
+     *
+     *  @param[in] line      - GPIO line message of the edge
+     *  @param[in] profileId - profile id of the line, charged with the run
+     *  @param[in] target    - what the action sets
+     *  @param[in] action    - the action, it must not refer to the line
+     *                         object, which may be gone when it runs
+     */
+    void replace(const std::string& line, uint32_t profileId,
+                 const std::string& target, Action&& action);
+
+    /** @brief Returns the number of queued actions */
+    size_t depth() const
+    {
+        return queue.size();
+    }
+
+    /** @brief Returns the most actions queued at once */
+    size_t highWater() const
+    {
+        return maxDepth;
+    }
+
+    /** @brief Returns the actions dropped by a full queue */
+    uint64_t dropped() const
+    {
+        return droppedCount;
+    }
+
+    /** @brief Returns the actions merged or replaced by a full queue */
+    uint64_t merged() const
+    {
+        return mergedCount;
+    }
+
+    /** @brief Publishes the counters on D-Bus
+     *
+     *  @param[in] server - object server hosting the counters
+     *  @param[in] path   - object path of the counters
+     *
+     *  @return the interface, the counters are removed with it
+     */
+    std::shared_ptr<sdbusplus::asio::dbus_interface>
+        publish(sdbusplus::asio::object_server& server,
+                const std::string& path);
+
+  private:
+    struct Entry
+    {
+        std::string line;
+        uint32_t profileId;
+        std::string target;
+        Action action;
+    };
+
+    /** @brief Makes room for a new action
+     *
+     *  @return false if the action was merged into a queued one
+     */
+    bool makeRoom(const std::string& line, uint32_t profileId,
+                  const std::string& target, Action& action);
+
+    /** @brief Runs the next action on the next loop turn */
+    void scheduleRun();
+
+    boost::asio::io_context& io;
+    const Config config;
+    std::deque<Entry> queue;
+
+    /** @brief Whether a run of the next action is posted */
+    bool scheduled = false;
+
+    size_t maxDepth = 0;
+    uint64_t droppedCount = 0;
+    uint64_t mergedCount = 0;
+};
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "chip_watch.hpp"
+
+#include "loop_lag.hpp"
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <boost/asio/buffer.hpp>
+#include <phosphor-logging/lg2.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+constexpr auto devDir = "/dev";
+constexpr std::string_view chipPrefix = "gpiochip";
+
+ChipWatcher::ChipWatcher(boost::asio::io_context& io, Handler handler) :
+    handler(std::move(handler)), inotify(io)
+{
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+    {
+        lg2::error("Failed to watch gpiochip devices: {ERROR}", "ERROR",
+                   strerror(errno));
+        return;
+    }
+
+    if (inotify_add_watch(fd, devDir, IN_CREATE | IN_DELETE) < 0)
+    {
+        lg2::error("Failed to watch {DIR}: {ERROR}", "DIR", devDir, "ERROR",
+                   strerror(errno));
+        close(fd);
+        return;
+    }
+
+    inotify.assign(fd);
+    scheduleRead();
+}
+
+void ChipWatcher::scheduleRead()
+{
+    inotify.async_read_some(
+        boost::asio::buffer(buffer),
+        [this](const boost::system::error_code& ec, size_t size) {
+            if (ec == boost::asio::error::operation_aborted)
+            {
+                return;
+            }
+            if (ec)
+            {
+                lg2::error("gpiochip watch error: {ERROR}", "ERROR",
+                           ec.message());
+                return;
+            }
+            handleEvents(size);
+            scheduleRead();
+        });
+}
+
+void ChipWatcher::handleEvents(size_t size)
+{
+    size_t offset = 0;
+    while (offset + sizeof(inotify_event) <= size)
+    {
+        const auto* event =
+            reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+        offset += sizeof(inotify_event) + event->len;
+
+        if (event->len == 0)
+        {
+            continue;
+        }
+
+        std::string name(event->name);
+        if (!name.starts_with(chipPrefix))
+        {
+            continue;
+        }
+
+        bool added = event->mask & IN_CREATE;
+        lg2::info("{CHIP} {ACTION}", "CHIP", name, "ACTION",
+                  added ? "added" : "removed");
+
+        looplag::Scope scope("gpiochip hotplug", name);
+        handler(name, added);
+    }
+}
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+
+#include <array>
+#include <functional>
+#include <string>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @class ChipWatcher
+ *  @brief Reports gpiochip devices appearing and disappearing.
+ *
+ *  Watches /dev with inotify, so that lines of a chip probed late or
+ *  rebound can be acquired without restarting the daemon.
+ */
+class ChipWatcher
+{
+  public:
+    /** @brief Called with the device name, for example gpiochip3, and
+     *         whether the chip was added or removed
+     */
+    using Handler = std::function<void(const std::string& chip, bool added)>;
+
+    ChipWatcher() = delete;
+    ~ChipWatcher() = default;
+    ChipWatcher(const ChipWatcher&) = delete;
+    ChipWatcher& operator=(const ChipWatcher&) = delete;
+    ChipWatcher(ChipWatcher&&) = delete;
+    ChipWatcher& operator=(ChipWatcher&&) = delete;
+
+    /** @brief Constructs ChipWatcher object.
+     *
+     *  @param[in] io      - io service
+     *  @param[in] handler - called when a chip is added or removed
+     */
+    ChipWatcher(boost::asio::io_context& io, Handler handler);
+
+  private:
+    /** @brief Waits for the next inotify events */
+    void scheduleRead();
+
+    /** @brief Reports the gpiochip events of the buffer */
+    void handleEvents(size_t size);
+
+    Handler handler;
+
+    /** @brief inotify descriptor watching /dev */
+    boost::asio::posix::stream_descriptor inotify;
+
+    /** @brief Buffer of the inotify events, aligned for inotify_event */
+    alignas(8) std::array<char, 4096> buffer{};
+};
+
+} // namespace gpio
+} // namespace phosphor
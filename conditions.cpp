@@ -0,0 +1,313 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "conditions.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <cctype>
+#include <stdexcept>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+size_t ConditionEngine::addLine(const std::string& name)
+{
+    auto [it, added] = lineIndex.try_emplace(name, lines.size());
+    if (added)
+    {
+        lines.push_back(false);
+        dependents.emplace_back();
+    }
+
+    return it->second;
+}
+
+std::vector<ConditionEngine::Instruction>
+    ConditionEngine::compile(const std::string& expression) const
+{
+    /* Recursive descent parser, precedence from low to high: ||, &&, ! */
+    struct Parser
+    {
+        const std::string& text;
+        const std::map<std::string, size_t>& lineIndex;
+        size_t pos = 0;
+        std::vector<Instruction> program;
+
+        void skipSpace()
+        {
+            while (pos < text.size() &&
+                   std::isspace(static_cast<unsigned char>(text[pos])))
+            {
+                pos++;
+            }
+        }
+
+        bool accept(const std::string& token)
+        {
+            skipSpace();
+            if (text.compare(pos, token.size(), token) == 0)
+            {
+                pos += token.size();
+                return true;
+            }
+            return false;
+        }
+
+        [[noreturn]] void fail(const std::string& what) const
+        {
+            throw std::invalid_argument(what + " at offset " +
+                                        std::to_string(pos) + " of '" + text +
+                                        "'");
+        }
+
+        void disjunction()
+        {
+            conjunction();
+            while (accept("||"))
+            {
+                conjunction();
+                program.push_back({Op::disjunction, 0});
+            }
+        }
+
+        void conjunction()
+        {
+            unary();
+            while (accept("&&"))
+            {
+                unary();
+                program.push_back({Op::conjunction, 0});
+            }
+        }
+
+        void unary()
+        {
+            if (accept("!"))
+            {
+                unary();
+                program.push_back({Op::negate, 0});
+                return;
+            }
+
+            if (accept("("))
+            {
+                disjunction();
+                if (!accept(")"))
+                {
+                    fail("Missing ')'");
+                }
+                return;
+            }
+
+            skipSpace();
+            auto start = pos;
+            while (pos < text.size() &&
+                   (std::isalnum(static_cast<unsigned char>(text[pos])) ||
+                    text[pos] == '_'))
+            {
+                pos++;
+            }
+            if (start == pos)
+            {
+                fail("Expected a line name");
+            }
+
+            auto name = text.substr(start, pos - start);
+            auto line = lineIndex.find(name);
+            if (line == lineIndex.end())
+            {
+                fail("Unknown line " + name);
+            }
+            program.push_back({Op::line, line->second});
+        }
+    };
+
+    Parser parser{expression, lineIndex, 0, {}};
+    parser.disjunction();
+    parser.skipSpace();
+    if (parser.pos != expression.size())
+    {
+        parser.fail("Unexpected character");
+    }
+
+    return std::move(parser.program);
+}
+
+void ConditionEngine::addCondition(const std::string& name,
+                                   const std::string& expression,
+                                   std::chrono::milliseconds hold,
+                                   const std::vector<std::string>& triggers,
+                                   Handler handler)
+{
+    Condition condition;
+    condition.name = name;
+    condition.program = compile(expression);
+    condition.hold = hold;
+    condition.handler = std::move(handler);
+    condition.triggers.assign(lines.size(), triggers.empty());
+
+    for (const auto& trigger : triggers)
+    {
+        auto line = lineIndex.find(trigger);
+        if (line == lineIndex.end())
+        {
+            throw std::invalid_argument("Unknown trigger line " + trigger);
+        }
+        condition.triggers[line->second] = true;
+    }
+
+    if (hold.count() > 0)
+    {
+        condition.holdTimer = std::make_unique<boost::asio::steady_timer>(io);
+    }
+
+    auto index = conditions.size();
+    for (const auto& instruction : condition.program)
+    {
+        if (instruction.op != Op::line)
+        {
+            continue;
+        }
+
+        auto& users = dependents[instruction.line];
+        if (users.empty() || users.back() != index)
+        {
+            users.push_back(index);
+        }
+    }
+
+    conditions.push_back(std::move(condition));
+}
+
+bool ConditionEngine::evaluate(const std::vector<Instruction>& program)
+{
+    stack.clear();
+
+    for (const auto& instruction : program)
+    {
+        switch (instruction.op)
+        {
+            case Op::line:
+                stack.push_back(lines[instruction.line]);
+                break;
+            case Op::negate:
+                stack.back() = !stack.back();
+                break;
+            case Op::conjunction:
+            {
+                bool rhs = stack.back();
+                stack.pop_back();
+                stack.back() = stack.back() && rhs;
+                break;
+            }
+            case Op::disjunction:
+            {
+                bool rhs = stack.back();
+                stack.pop_back();
+                stack.back() = stack.back() || rhs;
+                break;
+            }
+        }
+    }
+
+    return stack.back();
+}
+
+void ConditionEngine::setLine(size_t line, bool value)
+{
+    if (lines[line] == value)
+    {
+        return;
+    }
+    lines[line] = value;
+
+    if (!started)
+    {
+        return;
+    }
+
+    for (auto index : dependents[line])
+    {
+        update(index, conditions[index].triggers[line]);
+    }
+}
+
+void ConditionEngine::start()
+{
+    for (auto& condition : conditions)
+    {
+        condition.value = evaluate(condition.program);
+        condition.state = condition.value;
+    }
+    started = true;
+}
+
+bool ConditionEngine::state(const std::string& name) const
+{
+    for (const auto& condition : conditions)
+    {
+        if (condition.name == name)
+        {
+            return condition.state;
+        }
+    }
+
+    throw std::invalid_argument("Unknown condition " + name);
+}
+
+void ConditionEngine::update(size_t index, bool triggered)
+{
+    auto& condition = conditions[index];
+
+    auto value = evaluate(condition.program);
+    if (value == condition.value)
+    {
+        return;
+    }
+    condition.value = value;
+
+    if (!condition.holdTimer)
+    {
+        condition.triggered = triggered;
+        commit(condition);
+        return;
+    }
+
+    /* Back to the reported state before the hold time ran out */
+    if (value == condition.state)
+    {
+        condition.holdTimer->cancel();
+        return;
+    }
+
+    condition.triggered = triggered;
+    condition.holdTimer->expires_after(condition.hold);
+    condition.holdTimer->async_wait(
+        [this, index](const boost::system::error_code& ec) {
+            if (ec)
+            {
+                return;
+            }
+            commit(conditions[index]);
+        });
+}
+
+void ConditionEngine::commit(Condition& condition)
+{
+    condition.state = condition.value;
+
+    if (!condition.triggered)
+    {
+        return;
+    }
+
+    lg2::debug("Condition {NAME} changed to {STATE}", "NAME", condition.name,
+               "STATE", condition.state);
+    condition.handler(condition.state);
+}
+
+} // namespace gpio
+} // namespace phosphor
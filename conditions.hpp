@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @class ConditionEngine
+ *  @brief Evaluates boolean expressions over the state of several lines.
+ *
+ *  The engine keeps the last known value of every line. When a line
+ *  changes, only the conditions referring to it are evaluated again, so
+ *  the cost of an edge does not depend on the total number of conditions.
+ *
+ *  Expressions use line names, `!`, `&&`, `||` and parentheses, for
+ *  example `!PowerGood && !CpuPresent`. A line name is true while the line
+ *  is high.
+ */
+class ConditionEngine
+{
+  public:
+    /** @brief Called with the new state when a condition changes */
+    using Handler = std::function<void(bool state)>;
+
+    ConditionEngine() = delete;
+    ~ConditionEngine() = default;
+    ConditionEngine(const ConditionEngine&) = delete;
+    ConditionEngine& operator=(const ConditionEngine&) = delete;
+    ConditionEngine(ConditionEngine&&) = delete;
+    ConditionEngine& operator=(ConditionEngine&&) = delete;
+
+    /** @brief Constructs ConditionEngine object.
+     *
+     *  @param[in] io - io service running the hold timers
+     */
+    explicit ConditionEngine(boost::asio::io_context& io) : io(io) {}
+
+    /** @brief Adds a line that conditions can refer to.
+     *
+     *  @param[in] name - name used in the expressions
+     *
+     *  @return index of the line to pass to setLine()
+     */
+    size_t addLine(const std::string& name);
+
+    /** @brief Adds a condition.
+     *
+     *  @param[in] name       - name of the condition used for log
+     *  @param[in] expression - boolean expression over line names
+     *  @param[in] hold       - time the expression has to keep a new value
+     *                          before the condition changes
+     *  @param[in] triggers   - lines whose changes run the handler, all
+     *                          lines of the expression when empty. Changes
+     *                          caused by other lines only update the state.
+     *  @param[in] handler    - called when the condition changes
+     *
+     *  @throw std::invalid_argument if the expression is invalid or refers
+     *         to an unknown line
+     */
+    void addCondition(const std::string& name, const std::string& expression,
+                      std::chrono::milliseconds hold,
+                      const std::vector<std::string>& triggers,
+                      Handler handler);
+
+    /** @brief Updates the cached value of a line.
+     *
+     *  Before start() this only sets the initial value.
+     *
+     *  @param[in] line  - index returned by addLine()
+     *  @param[in] value - new value of the line
+     */
+    void setLine(size_t line, bool value);
+
+    /** @brief Evaluates all conditions with the initial line values and
+     *         starts reacting to changes. No handler is run for the
+     *         initial states.
+     */
+    void start();
+
+    /** @brief Returns the current state of a condition
+     *
+     *  @param[in] name - name of the condition
+     */
+    bool state(const std::string& name) const;
+
+  private:
+    /** @brief Operations of a compiled expression, in postfix order */
+    enum class Op : uint8_t
+    {
+        line,
+        negate,
+        conjunction,
+        disjunction,
+    };
+
+    struct Instruction
+    {
+        Op op;
+        size_t line;
+    };
+
+    struct Condition
+    {
+        std::string name;
+        std::vector<Instruction> program;
+        std::chrono::milliseconds hold;
+        /** @brief Lines whose changes run the handler, indexed by line */
+        std::vector<bool> triggers;
+        Handler handler;
+        /** @brief Last value of the expression */
+        bool value = false;
+        /** @brief State reported to the handler */
+        bool state = false;
+        /** @brief Whether the pending change was caused by a trigger line */
+        bool triggered = false;
+        std::unique_ptr<boost::asio::steady_timer> holdTimer;
+    };
+
+    /** @brief Compiles an expression into a postfix program */
+    std::vector<Instruction> compile(const std::string& expression) const;
+
+    /** @brief Evaluates a compiled expression on the cached line values */
+    bool evaluate(const std::vector<Instruction>& program);
+
+    /** @brief Handles a new value of the expression of a condition */
+    void update(size_t index, bool triggered);
+
+    /** @brief Makes a pending value the state of a condition */
+    void commit(Condition& condition);
+
+    /** @brief io service running the hold timers */
+    boost::asio::io_context& io;
+
+    /** @brief Line name to line index */
+    std::map<std::string, size_t> lineIndex;
+
+    /** @brief Cached value of each line */
+    std::vector<bool> lines;
+
+    /** @brief Indexes of the conditions referring to each line */
+    std::vector<std::vector<size_t>> dependents;
+
+    std::vector<Condition> conditions;
+
+    /** @brief Evaluation stack, kept to avoid allocating on every edge */
+    std::vector<bool> stack;
+
+    /** @brief Whether start() was called */
+    bool started = false;
+};
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "config_line.hpp"
+
+namespace phosphor
+{
+namespace gpio
+{
+
+bool findLine(ConfigLine& entry)
+{
+    startup::Phase resolve("resolve");
+    if (entry.lineName.empty())
+    {
+        entry.line = gpiod_line_get(entry.chipId.c_str(), entry.gpioNum);
+    }
+    else
+    {
+        entry.line = gpiod_line_find(entry.lineName.c_str());
+    }
+
+    if (entry.line == nullptr)
+    {
+        return false;
+    }
+    entry.chip = gpiod_chip_name(gpiod_line_get_chip(entry.line));
+
+    return true;
+}
+
+void closeLine(ConfigLine& entry)
+{
+    gpiod_line_close_chip(entry.line);
+    entry.line = nullptr;
+    entry.chip.clear();
+}
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include "line_watch.hpp"
+#include "poller.hpp"
+#include "startup.hpp"
+
+#include <gpiod.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <phosphor-logging/lg2.hpp>
+
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @brief Where a line of the config file of a multi line daemon is and how
+ *         it is requested
+ *
+ *  The entries of the daemons derive from it and add a gpio member, the
+ *  GpioMonitor or GpioPresence of the line while it is acquired.
+ */
+struct ConfigLine
+{
+    /** @brief GPIO line message used for log */
+    std::string lineMsg;
+
+    /** @brief Line name, empty when the line is given by chip and offset */
+    std::string lineName;
+    std::string chipId;
+    int gpioNum = -1;
+
+    gpiod_line_request_config config{
+        "gpio_monitor", GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES, 0};
+
+    /** @brief Line and chip device name, set while the line is acquired */
+    gpiod_line* line = nullptr;
+    std::string chip;
+};
+
+/** @brief Finds the line of an entry and sets its line and chip
+ *
+ *  @return false if the chip of the line is not there yet
+ */
+bool findLine(ConfigLine& entry);
+
+/** @brief Closes the chip of a line found by findLine(), the line is
+ *         looked up again when its chip is there
+ */
+void closeLine(ConfigLine& entry);
+
+/** @brief Acquires the lines whose chip was missing and watches them for
+ *         changes made by other consumers
+ *
+ *  @param[in] entries - entries of the config file
+ *  @param[in] poller  - poller of the lines without edge events
+ *  @param[in] watcher - watcher of the requests of other consumers
+ *  @param[in] start   - creates the monitor of an entry whose line was
+ *                       found
+ *  @param[in] started - optional, called once the line of an entry is
+ *                       requested and again after each retried request
+ */
+template <typename Entry>
+void acquirePending(
+    std::vector<Entry>& entries, LinePoller& poller, LineInfoWatcher& watcher,
+    const std::type_identity_t<std::function<void(Entry&)>>& start,
+    const std::type_identity_t<std::function<void(Entry&)>>& started = {})
+{
+    std::vector<Entry*> acquired;
+    for (auto& entry : entries)
+    {
+        if (entry.gpio || !findLine(entry))
+        {
+            continue;
+        }
+
+        startup::Phase request("request");
+        start(entry);
+
+        /* A polled line missing from the poller would never report a
+         * value, it waits for its chip again instead */
+        if (entry.gpio->polled() &&
+            poller.addLine(entry.line, entry.config.flags, entry.lineMsg,
+                           [gpio = entry.gpio.get()](bool value,
+                                                     const timespec& ts) {
+                               gpio->pollEvent(value, ts);
+                           }) < 0)
+        {
+            entry.gpio.reset();
+            closeLine(entry);
+            continue;
+        }
+        acquired.push_back(&entry);
+    }
+
+    /* Polled lines get their initial value here */
+    startup::Phase request("request");
+    /* A group which failed to be requested is retried by the poller, its
+     * lines get their initial value then */
+    poller.start();
+    request.end();
+
+    for (auto* entry : acquired)
+    {
+        /* A line held by another consumer is requested on its release */
+        watcher.watch(entry->chip, gpiod_line_offset(entry->line),
+                      entry->lineMsg, [entry, started]() {
+                          if (entry->gpio)
+                          {
+                              entry->gpio->retryRequest();
+                              if (started)
+                              {
+                                  started(*entry);
+                              }
+                          }
+                      });
+        if (started)
+        {
+            started(*entry);
+        }
+    }
+}
+
+/** @brief Stops monitoring the lines of a removed chip, they are acquired
+ *         again when it comes back
+ *
+ *  @param[in] entries  - entries of the config file
+ *  @param[in] chip     - device name of the removed chip
+ *  @param[in] io       - io service running the handlers of the lines
+ *  @param[in] poller   - poller of the lines without edge events
+ *  @param[in] watcher  - watcher of the requests of other consumers
+ *  @param[in] released - optional, called for each released entry
+ */
+template <typename Entry>
+void releaseChip(
+    std::vector<Entry>& entries, const std::string& chip,
+    boost::asio::io_context& io, LinePoller& poller, LineInfoWatcher& watcher,
+    const std::type_identity_t<std::function<void(Entry&)>>& released = {})
+{
+    poller.removeChip(chip);
+    watcher.removeChip(chip);
+
+    for (auto& entry : entries)
+    {
+        if (!entry.gpio || entry.chip != chip)
+        {
+            continue;
+        }
+
+        lg2::info("{GPIO} removed with {CHIP}, waiting for it", "GPIO",
+                  entry.lineMsg, "CHIP", chip);
+
+        /* Handlers of the line already queued still run, release it after
+         * them */
+        boost::asio::post(io, [gpio = std::move(entry.gpio),
+                               line = entry.line]() mutable {
+            gpio.reset();
+            gpiod_line_close_chip(line);
+        });
+        entry.line = nullptr;
+        entry.chip.clear();
+
+        if (released)
+        {
+            released(entry);
+        }
+    }
+}
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,249 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "dbus_action.hpp"
+
+#include "trace.hpp"
+
+#include <systemd/sd-bus.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <stdexcept>
+#include <utility>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+namespace
+{
+
+constexpr auto PROPERTIES_INTERFACE = "org.freedesktop.DBus.Properties";
+
+/** @brief Returns an integer value if it fits T */
+template <typename T>
+std::optional<DBusAction::Arg> integer(const nlohmann::json& value)
+{
+    if (value.is_number_unsigned())
+    {
+        auto number = value.get<uint64_t>();
+        if (std::in_range<T>(number))
+        {
+            return static_cast<T>(number);
+        }
+    }
+    else if (value.is_number_integer())
+    {
+        auto number = value.get<int64_t>();
+        if (std::in_range<T>(number))
+        {
+            return static_cast<T>(number);
+        }
+    }
+    return std::nullopt;
+}
+
+/** @brief Returns a required string of an action */
+std::string required(const nlohmann::json& obj, const char* key)
+{
+    auto it = obj.find(key);
+    if (it == obj.end() || !it->is_string())
+    {
+        throw std::invalid_argument(std::string("missing ") + key);
+    }
+    return it->get<std::string>();
+}
+
+/** @brief Returns a required D-Bus name of an action, checked by valid so
+ *         that a bad name is rejected at config load and not by the call
+ */
+std::string requiredName(const nlohmann::json& obj, const char* key,
+                         int (*valid)(const char*))
+{
+    auto name = required(obj, key);
+    if (valid(name.c_str()) <= 0)
+    {
+        throw std::invalid_argument(std::string("invalid ") + key + " " +
+                                    name);
+    }
+    return name;
+}
+
+/** @brief Returns the Signature of an action, empty if it has none */
+std::string signatureOf(const nlohmann::json& obj)
+{
+    auto it = obj.find("Signature");
+    if (it == obj.end())
+    {
+        return {};
+    }
+    if (!it->is_string())
+    {
+        throw std::invalid_argument("the Signature must be a string");
+    }
+    return it->get<std::string>();
+}
+
+} // namespace
+
+std::optional<DBusAction::Arg> DBusAction::parseArg(
+    const nlohmann::json& value, char type)
+{
+    if (type == 0)
+    {
+        if (value.is_string())
+        {
+            type = 's';
+        }
+        else if (value.is_boolean())
+        {
+            type = 'b';
+        }
+        else if (value.is_number_integer())
+        {
+            type = 'i';
+        }
+        else
+        {
+            type = 'd';
+        }
+    }
+
+    switch (type)
+    {
+        case 'b':
+            if (value.is_boolean())
+            {
+                return value.get<bool>();
+            }
+            break;
+        case 'y':
+            return integer<uint8_t>(value);
+        case 'n':
+            return integer<int16_t>(value);
+        case 'q':
+            return integer<uint16_t>(value);
+        case 'i':
+            return integer<int32_t>(value);
+        case 'u':
+            return integer<uint32_t>(value);
+        case 'x':
+            return integer<int64_t>(value);
+        case 't':
+            return integer<uint64_t>(value);
+        case 'd':
+            if (value.is_number())
+            {
+                return value.get<double>();
+            }
+            break;
+        case 's':
+            if (value.is_string())
+            {
+                return value.get<std::string>();
+            }
+            break;
+        case 'o':
+            if (value.is_string())
+            {
+                return sdbusplus::object_path(value.get<std::string>());
+            }
+            break;
+        default:
+            break;
+    }
+    return std::nullopt;
+}
+
+DBusAction::DBusAction(const nlohmann::json& obj) :
+    service(requiredName(obj, "Service", sd_bus_service_name_is_valid)),
+    path(requiredName(obj, "Path", sd_bus_object_path_is_valid)),
+    interface(requiredName(obj, "Interface", sd_bus_interface_name_is_valid)),
+    setProperty(obj.find("Property") != obj.end())
+{
+    member = requiredName(obj, setProperty ? "Property" : "Method",
+                          sd_bus_member_name_is_valid);
+    description = path + " " + interface + "." + member;
+
+    auto signature = signatureOf(obj);
+    std::vector<nlohmann::json> values;
+    if (setProperty)
+    {
+        if (obj.find("Value") == obj.end() || signature.size() > 1)
+        {
+            throw std::invalid_argument(
+                "a property needs a Value of a basic type");
+        }
+        values.push_back(obj["Value"]);
+    }
+    else
+    {
+        if (auto it = obj.find("Args"); it != obj.end())
+        {
+            if (!it->is_array())
+            {
+                throw std::invalid_argument("the Args must be an array");
+            }
+            values.assign(it->begin(), it->end());
+        }
+        if (!signature.empty() && signature.size() != values.size())
+        {
+            throw std::invalid_argument(
+                "the Signature does not match the Args");
+        }
+    }
+
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        auto arg = parseArg(values[i], signature.empty() ? 0 : signature[i]);
+        if (!arg)
+        {
+            throw std::invalid_argument("invalid argument " +
+                                        std::to_string(i) + " of " +
+                                        description);
+        }
+        args.push_back(std::move(*arg));
+    }
+}
+
+void DBusAction::run(sdbusplus::asio::connection& conn,
+                     ratelimit::Limiter& logLimit) const
+{
+    auto method =
+        setProperty
+            ? conn.new_method_call(service.c_str(), path.c_str(),
+                                   PROPERTIES_INTERFACE, "Set")
+            : conn.new_method_call(service.c_str(), path.c_str(),
+                                   interface.c_str(), member.c_str());
+
+    if (setProperty)
+    {
+        /* The property value is sent as a variant */
+        method.append(interface, member, args.front());
+    }
+    else
+    {
+        for (const auto& arg : args)
+        {
+            std::visit([&method](const auto& value) { method.append(value); },
+                       arg);
+        }
+    }
+
+    GPIO_TRACE(action_start, description.c_str());
+    conn.async_send(method, [name = description, &logLimit](
+                                const boost::system::error_code& ec,
+                                sdbusplus::message_t) {
+        GPIO_TRACE(action_end, name.c_str(), -ec.value());
+        if (ec)
+        {
+            ratelimit::error(logLimit, "Failed to call {ACTION}: {ERROR}",
+                             "ACTION", name, "ERROR", ec.message());
+        }
+    });
+}
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include "ratelimit.hpp"
+
+#include <nlohmann/json.hpp>
+#include <sdbusplus/asio/connection.hpp>
+#include <sdbusplus/message.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @class DBusAction
+ *  @brief Property set or method call made on an edge, instead of starting
+ *         a unit running busctl.
+ *
+ *  The arguments are parsed once from the config file. The call is sent on
+ *  the connection of the daemon without waiting for its reply, which is
+ *  only checked for an error.
+ */
+class DBusAction
+{
+  public:
+    /** @brief Argument of a D-Bus basic type */
+    using Arg = std::variant<bool, uint8_t, int16_t, uint16_t, int32_t,
+                             uint32_t, int64_t, uint64_t, double, std::string,
+                             sdbusplus::object_path>;
+
+    /** @brief Parses an action of the config file
+     *
+     *  @param[in] obj - object with Service, Path and Interface, and either
+     *                   Property and Value or Method and Args
+     *
+     *  @throw std::invalid_argument if the action is invalid
+     */
+    explicit DBusAction(const nlohmann::json& obj);
+
+    /** @brief Parses a value of the config file as a D-Bus basic type
+     *
+     *  @param[in] value - value of the config file
+     *  @param[in] type  - D-Bus type code, 0 to take the JSON type: strings
+     *                     as s, booleans as b, integers as i and other
+     *                     numbers as d
+     *
+     *  @return nullopt if the value does not fit the type
+     */
+    static std::optional<Arg> parseArg(const nlohmann::json& value,
+                                       char type);
+
+    /** @brief Sends the property set or method call
+     *
+     *  @param[in] conn     - connection of the daemon
+     *  @param[in] logLimit - rate limiter of the line of the edge
+     */
+    void run(sdbusplus::asio::connection& conn,
+             ratelimit::Limiter& logLimit) const;
+
+    /** @brief Returns the object path and member of the action, for log */
+    const std::string& name() const
+    {
+        return description;
+    }
+
+  private:
+    std::string service;
+    std::string path;
+    std::string interface;
+    /** @brief Property or method */
+    std::string member;
+    bool setProperty;
+    /** @brief Value of the property, or method arguments */
+    std::vector<Arg> args;
+    std::string description;
+};
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "event_journal.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace journal
+{
+
+namespace
+{
+
+Header* header = nullptr;
+Record* records = nullptr;
+size_t mapSize = 0;
+
+/** @brief Names of the lines, kept even while the journal is not open */
+std::vector<std::string> names;
+
+/** @brief Writes the name of a line to the name table and counts it */
+void publish(uint32_t id)
+{
+    if (header == nullptr || id >= maxLines)
+    {
+        return;
+    }
+
+    auto len = std::min(names[id].size(), lineNameSize - 1);
+    std::memcpy(header->lineNames[id], names[id].data(), len);
+    std::atomic_ref<uint32_t>(header->lineCount)
+        .store(id + 1, std::memory_order_release);
+}
+
+} // namespace
+
+int open(const std::string& path, clockid_t clockId, uint32_t capacity)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(
+        std::filesystem::path(path).parent_path(), ec);
+
+    /* Truncating the file readers have mapped would fault them, so the new
+     * journal is built aside and renamed over the path */
+    std::string tmpPath = path + ".XXXXXX";
+    int fd = mkostemp(tmpPath.data(), O_CLOEXEC);
+    if (fd < 0)
+    {
+        auto err = errno;
+        lg2::error("Failed to create event journal {PATH}: {ERROR}", "PATH",
+                   path, "ERROR", strerror(err));
+        return -err;
+    }
+
+    auto size = sizeof(Header) + sizeof(Record) * capacity;
+    if (fchmod(fd, 0644) < 0 || ftruncate(fd, size) < 0)
+    {
+        auto err = errno;
+        lg2::error("Failed to size event journal {PATH}: {ERROR}", "PATH",
+                   path, "ERROR", strerror(err));
+        close(fd);
+        unlink(tmpPath.c_str());
+        return -err;
+    }
+
+    void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        auto err = errno;
+        lg2::error("Failed to map event journal {PATH}: {ERROR}", "PATH",
+                   path, "ERROR", strerror(err));
+        unlink(tmpPath.c_str());
+        return -err;
+    }
+
+    /* The new file starts zero filled */
+    auto journal = static_cast<Header*>(map);
+    journal->magic = magic;
+    journal->version = version;
+    journal->recordSize = sizeof(Record);
+    journal->capacity = capacity;
+    journal->clockId = clockId;
+
+    if (rename(tmpPath.c_str(), path.c_str()) < 0)
+    {
+        auto err = errno;
+        lg2::error("Failed to publish event journal {PATH}: {ERROR}", "PATH",
+                   path, "ERROR", strerror(err));
+        munmap(map, size);
+        unlink(tmpPath.c_str());
+        return -err;
+    }
+
+    if (header != nullptr)
+    {
+        munmap(header, mapSize);
+    }
+    header = journal;
+    records = reinterpret_cast<Record*>(header + 1);
+    mapSize = size;
+    for (uint32_t id = 0; id < names.size(); id++)
+    {
+        publish(id);
+    }
+
+    return 0;
+}
+
+uint32_t addLine(const std::string& name)
+{
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it != names.end())
+    {
+        return it - names.begin();
+    }
+
+    uint32_t id = names.size();
+    names.push_back(name);
+    publish(id);
+
+    return id;
+}
+
+bool record(uint32_t lineId, Edge edge, const timespec& ts, uint8_t actions,
+            int32_t result)
+{
+    if (header == nullptr)
+    {
+        return false;
+    }
+
+    auto sequence = header->head + 1;
+    auto& rec = records[(sequence - 1) % header->capacity];
+
+    /* Readers skip the slot until the new sequence is published */
+    std::atomic_ref<uint64_t>(rec.sequence).store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    rec.timestampNs = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL +
+                      static_cast<uint64_t>(ts.tv_nsec);
+    rec.lineId = lineId;
+    rec.result = result;
+    rec.edge = edge;
+    rec.actions = actions;
+
+    std::atomic_ref<uint64_t>(rec.sequence)
+        .store(sequence, std::memory_order_release);
+    std::atomic_ref<uint64_t>(header->head)
+        .store(sequence, std::memory_order_release);
+
+    return true;
+}
+
+} // namespace journal
+} // namespace gpio
+} // namespace phosphor
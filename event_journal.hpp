@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <time.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace journal
+{
+
+/** @brief "GPIJ", identifies a GPIO event journal file */
+constexpr uint32_t magic = 0x4750494a;
+constexpr uint32_t version = 1;
+
+/** @brief Number of records kept by default before wrapping */
+constexpr uint32_t defaultCapacity = 4096;
+
+/** @brief Size of the line name table in the file header */
+constexpr size_t maxLines = 256;
+constexpr size_t lineNameSize = 64;
+
+/** @brief Directory holding the journal files of all daemons */
+constexpr auto journalDir = "/run/phosphor-gpio-monitor";
+
+enum class Edge : uint8_t
+{
+    falling = 0,
+    rising = 1,
+};
+
+/** @struct Header
+ *  @brief Start of the journal file, followed by `capacity` records.
+ */
+struct Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t capacity;
+    uint32_t lineCount;
+    /** @brief Clock of the record timestamps */
+    int32_t clockId;
+    /** @brief Sequence number of the last complete record */
+    uint64_t head;
+    char lineNames[maxLines][lineNameSize];
+};
+
+/** @struct Record
+ *  @brief One handled edge, written into the ring at (sequence - 1) %
+ *  capacity.
+ */
+struct Record
+{
+    /** @brief Written last, 0 while the record is being updated */
+    uint64_t sequence;
+    /** @brief Kernel timestamp of the edge */
+    uint64_t timestampNs;
+    uint32_t lineId;
+    /** @brief 0 on success, negative errno if an action failed */
+    int32_t result;
+    Edge edge;
+    /** @brief Number of actions dispatched for the edge */
+    uint8_t actions;
+    uint8_t reserved[6];
+};
+
+static_assert(sizeof(Record) == 32);
+static_assert(sizeof(Header) % alignof(Record) == 0);
+
+/** @brief Opens the journal of this daemon, creating it or replacing it
+ *         with an empty one.
+ *
+ *  The new journal is renamed over the path, so a reader which mapped the
+ *  previous one keeps reading it. Until this succeeds, record() does
+ *  nothing and returns false.
+ *
+ *  @param[in] path     - journal file, usually under journalDir
+ *  @param[in] clockId  - clock used by the timestamps passed to record()
+ *  @param[in] capacity - number of records kept before wrapping
+ *
+ *  @return 0 on success and negative errno otherwise
+ */
+int open(const std::string& path, clockid_t clockId,
+         uint32_t capacity = defaultCapacity);
+
+/** @brief Adds a line to the name table of the journal.
+ *
+ *  A line acquired again keeps its id. Lines added before open() are
+ *  written to the table when it opens.
+ *
+ *  @param[in] name - line name, truncated to fit the table
+ *
+ *  @return line id to pass to record(), the same for the same name
+ */
+uint32_t addLine(const std::string& name);
+
+/** @brief Appends an edge record to the journal.
+ *
+ *  @param[in] lineId  - id returned by addLine()
+ *  @param[in] edge    - edge seen on the line
+ *  @param[in] ts      - kernel timestamp of the edge
+ *  @param[in] actions - number of actions dispatched
+ *  @param[in] result  - 0 on success, negative errno if an action failed
+ *
+ *  @return false if the journal is not open, so the caller can fall back
+ *          to the system journal
+ */
+bool record(uint32_t lineId, Edge edge, const timespec& ts, uint8_t actions,
+            int32_t result);
+
+} // namespace journal
+} // namespace gpio
+} // namespace phosphor
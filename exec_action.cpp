@@ -0,0 +1,303 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "exec_action.hpp"
+
+#include "trace.hpp"
+
+#include <sched.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+extern char** environ;
+
+namespace phosphor
+{
+namespace gpio
+{
+
+namespace
+{
+
+/** @brief Returns the MaxRunning of an action, 1 by default */
+size_t getMaxRunning(const nlohmann::json& obj)
+{
+    auto it = obj.find("MaxRunning");
+    if (it == obj.end())
+    {
+        return 1;
+    }
+    if (!it->is_number_unsigned() || it->get<uint64_t>() == 0)
+    {
+        throw std::invalid_argument("MaxRunning must be a positive integer");
+    }
+    return it->get<size_t>();
+}
+
+/** @brief Returns the variables of the Env object of an action */
+std::map<std::string, std::string> getEnv(const nlohmann::json& obj)
+{
+    std::map<std::string, std::string> vars;
+    auto it = obj.find("Env");
+    if (it == obj.end())
+    {
+        return vars;
+    }
+    if (!it->is_object())
+    {
+        throw std::invalid_argument("Env must be an object");
+    }
+    for (const auto& [name, value] : it->items())
+    {
+        if (!value.is_string())
+        {
+            throw std::invalid_argument("Env " + name + " must be a string");
+        }
+        vars[name] = value.get<std::string>();
+    }
+    return vars;
+}
+
+/** @brief Checks an action before any of its fields is read */
+const nlohmann::json& checkObject(const nlohmann::json& obj)
+{
+    if (!obj.is_object())
+    {
+        throw std::invalid_argument("action must be an object");
+    }
+    return obj;
+}
+
+} // namespace
+
+ExecAction::ExecAction(boost::asio::io_context& io,
+                       const nlohmann::json& obj,
+                       const std::map<std::string, std::string>& env,
+                       ratelimit::Limiter& logLimit) :
+    io(io), logLimit(logLimit), maxRunning(getMaxRunning(checkObject(obj)))
+{
+    auto commandObj = obj.find("Command");
+    if (commandObj == obj.end() || !commandObj->is_array() ||
+        commandObj->empty())
+    {
+        throw std::invalid_argument("missing Command");
+    }
+    for (const auto& arg : *commandObj)
+    {
+        if (!arg.is_string())
+        {
+            throw std::invalid_argument("Command must only hold strings");
+        }
+        args.push_back(arg.get<std::string>());
+    }
+    if (args.front().empty() || args.front().front() != '/')
+    {
+        throw std::invalid_argument(args.front() + " is not an absolute path");
+    }
+    if (access(args.front().c_str(), X_OK) < 0)
+    {
+        throw std::invalid_argument(args.front() + ": " + strerror(errno));
+    }
+    for (const auto& arg : args)
+    {
+        command += command.empty() ? arg : " " + arg;
+    }
+
+    /* The environment of the daemon, overridden by the variables of the
+     * line and then of the action */
+    auto vars = env;
+    for (const auto& [name, value] : getEnv(obj))
+    {
+        vars[name] = value;
+    }
+    for (char** var = environ; *var != nullptr; var++)
+    {
+        std::string entry = *var;
+        if (!vars.contains(entry.substr(0, entry.find('='))))
+        {
+            envs.push_back(std::move(entry));
+        }
+    }
+    for (const auto& [name, value] : vars)
+    {
+        envs.push_back(name + "=" + value);
+    }
+
+    for (auto& arg : args)
+    {
+        argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+    for (auto& var : envs)
+    {
+        envp.push_back(var.data());
+    }
+    envp.push_back(nullptr);
+
+    /* Children get the default signal handling and scheduling, even when
+     * the daemon runs SCHED_FIFO */
+    posix_spawnattr_init(&attr);
+    sigset_t signals;
+    sigemptyset(&signals);
+    posix_spawnattr_setsigmask(&attr, &signals);
+    sigfillset(&signals);
+    posix_spawnattr_setsigdefault(&attr, &signals);
+    sched_param param{};
+    posix_spawnattr_setschedpolicy(&attr, SCHED_OTHER);
+    posix_spawnattr_setschedparam(&attr, &param);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK |
+                                        POSIX_SPAWN_SETSIGDEF |
+                                        POSIX_SPAWN_SETSCHEDULER);
+}
+
+ExecAction::~ExecAction()
+{
+    posix_spawnattr_destroy(&attr);
+}
+
+void ExecAction::run()
+{
+    if (running.size() >= maxRunning)
+    {
+        counters.skipped++;
+        ratelimit::info(
+            logLimit,
+            "Skipped running {COMMAND}, {RUNNING} instances run, {COUNT} runs skipped",
+            "COMMAND", command, "RUNNING", running.size(), "COUNT",
+            counters.skipped);
+        return;
+    }
+
+    GPIO_TRACE(action_start, command.c_str());
+    pid_t pid = 0;
+    int rc = posix_spawn(&pid, argv.front(), nullptr, &attr, argv.data(),
+                         envp.data());
+    if (rc != 0)
+    {
+        counters.runs++;
+        counters.failed++;
+        counters.lastStatus = -rc;
+        GPIO_TRACE(action_end, command.c_str(), -rc);
+        ratelimit::error(logLimit, "Failed to run {COMMAND}: {ERROR}",
+                         "COMMAND", command, "ERROR", strerror(rc));
+        return;
+    }
+
+    auto child = running.emplace(running.end(), io, pid);
+
+    int pidfd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+    if (pidfd >= 0)
+    {
+        child->pidfd.assign(pidfd);
+    }
+    else
+    {
+        ratelimit::warning(logLimit,
+                           "Failed to open a pidfd of {COMMAND}: {ERROR}",
+                           "COMMAND", command, "ERROR", strerror(errno));
+    }
+
+    wait(child);
+}
+
+void ExecAction::wait(std::list<Child>::iterator child)
+{
+    auto handler = [this, child](const boost::system::error_code& ec) {
+        if (ec == boost::asio::error::operation_aborted)
+        {
+            // we were cancelled, the action may be gone
+            return;
+        }
+        if (!reap(child))
+        {
+            wait(child);
+        }
+    };
+
+    /* Without a pidfd, the child is reaped by polling */
+    if (child->pidfd.is_open())
+    {
+        child->pidfd.async_wait(
+            boost::asio::posix::stream_descriptor::wait_read, handler);
+    }
+    else
+    {
+        child->timer.expires_after(reapInterval);
+        child->timer.async_wait(handler);
+    }
+}
+
+bool ExecAction::reap(std::list<Child>::iterator child)
+{
+    int status = 0;
+    pid_t rc = waitpid(child->pid, &status, WNOHANG);
+    if (rc == 0)
+    {
+        return false;
+    }
+    int error = errno;
+
+    auto runtime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - child->start);
+    running.erase(child);
+
+    counters.runs++;
+    counters.totalRuntime += runtime;
+    counters.maxRuntime = std::max(counters.maxRuntime, runtime);
+
+    /* Statuses follow the shell, 128 plus the signal killing the child */
+    if (rc < 0)
+    {
+        counters.lastStatus = -error;
+    }
+    else if (WIFEXITED(status))
+    {
+        counters.lastStatus = WEXITSTATUS(status);
+    }
+    else
+    {
+        counters.lastStatus = 128 + WTERMSIG(status);
+    }
+    GPIO_TRACE(action_end, command.c_str(), counters.lastStatus);
+
+    if (counters.lastStatus != 0)
+    {
+        counters.failed++;
+        ratelimit::warning(
+            logLimit, "{COMMAND} exited with {STATUS} after {RUNTIME_US} us",
+            "COMMAND", command, "STATUS", counters.lastStatus, "RUNTIME_US",
+            runtime.count());
+    }
+
+    return true;
+}
+
+void ExecAction::dumpStats() const
+{
+    if (counters.runs == 0 && counters.skipped == 0)
+    {
+        return;
+    }
+
+    auto meanUs =
+        counters.runs > 0 ? counters.totalRuntime.count() / counters.runs : 0;
+    lg2::info("{COMMAND} ran {COUNT} times, {FAILED} failed, {SKIPPED} "
+              "skipped, last status {STATUS}, runtime mean {MEAN_US} us, "
+              "max {MAX_US} us",
+              "COMMAND", command, "COUNT", counters.runs, "FAILED",
+              counters.failed, "SKIPPED", counters.skipped, "STATUS",
+              counters.lastStatus, "MEAN_US", meanUs, "MAX_US",
+              counters.maxRuntime.count());
+}
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include "ratelimit.hpp"
+
+#include <spawn.h>
+#include <sys/types.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @class ExecAction
+ *  @brief Program run on an edge, instead of starting a unit running it.
+ *
+ *  The program is spawned with posix_spawn, which glibc implements with a
+ *  vfork style clone, from an argument vector and environment built when
+ *  the config file is loaded. Exited children are reaped through a pidfd
+ *  watched by the event loop. At most a configured number of instances run
+ *  at once, an edge coming while they all run is skipped.
+ */
+class ExecAction
+{
+  public:
+    /** @brief Runs of the program */
+    struct Stats
+    {
+        /** @brief Finished runs and failed spawns */
+        uint64_t runs = 0;
+        /** @brief Runs which failed to spawn or exited with a non-zero
+         *         status */
+        uint64_t failed = 0;
+        /** @brief Edges coming while MaxRunning instances ran */
+        uint64_t skipped = 0;
+        /** @brief Exit status of the last run, 128 plus the signal killing
+         *         it, or a negative errno */
+        int lastStatus = 0;
+        std::chrono::microseconds totalRuntime{0};
+        std::chrono::microseconds maxRuntime{0};
+    };
+
+    ExecAction() = delete;
+    ~ExecAction();
+    ExecAction(const ExecAction&) = delete;
+    ExecAction& operator=(const ExecAction&) = delete;
+    ExecAction(ExecAction&&) = delete;
+    ExecAction& operator=(ExecAction&&) = delete;
+
+    /** @brief Parses an action of the config file
+     *
+     *  @param[in] io       - io service reaping the children
+     *  @param[in] obj      - object with the Command array, and optional
+     *                        Env object and MaxRunning
+     *  @param[in] env      - variables added to the environment of the
+     *                        daemon, before the ones of Env
+     *  @param[in] logLimit - rate limiter of the line of the edges
+     *
+     *  @throw std::invalid_argument if the action is invalid
+     */
+    ExecAction(boost::asio::io_context& io, const nlohmann::json& obj,
+               const std::map<std::string, std::string>& env,
+               ratelimit::Limiter& logLimit);
+
+    /** @brief Spawns the program, unless too many instances run */
+    void run();
+
+    /** @brief Returns the runs of the program */
+    const Stats& stats() const
+    {
+        return counters;
+    }
+
+    /** @brief Returns the number of instances running */
+    size_t instances() const
+    {
+        return running.size();
+    }
+
+    /** @brief Logs the runs of the program, their exit status and runtime */
+    void dumpStats() const;
+
+  private:
+    /** @brief Interval of the reaping of a child without a pidfd */
+    static constexpr auto reapInterval = std::chrono::milliseconds(100);
+
+    /** @brief Running instance of the program */
+    struct Child
+    {
+        Child(boost::asio::io_context& io, pid_t pid) :
+            pid(pid), pidfd(io), timer(io),
+            start(std::chrono::steady_clock::now())
+        {}
+
+        pid_t pid;
+        /** @brief Readable once the child exited */
+        boost::asio::posix::stream_descriptor pidfd;
+        /** @brief Reaps the child on kernels without pidfd */
+        boost::asio::steady_timer timer;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    /** @brief Waits for a child to exit */
+    void wait(std::list<Child>::iterator child);
+
+    /** @brief Reaps a child if it exited and records its status
+     *
+     *  @return false if the child still runs
+     */
+    bool reap(std::list<Child>::iterator child);
+
+    boost::asio::io_context& io;
+    ratelimit::Limiter& logLimit;
+
+    /** @brief Program and arguments, for log */
+    std::string command;
+
+    /** @brief Strings of the argument vector and environment, and their
+     *         null terminated pointer arrays */
+    std::vector<std::string> args;
+    std::vector<std::string> envs;
+    std::vector<char*> argv;
+    std::vector<char*> envp;
+
+    posix_spawnattr_t attr;
+    size_t maxRunning;
+    std::list<Child> running;
+
+    Stats counters;
+};
+
+} // namespace gpio
+} // namespace phosphor
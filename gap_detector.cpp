@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "gap_detector.hpp"
+
+namespace phosphor
+{
+namespace gpio
+{
+
+GapDetector::Edge GapDetector::edge(bool rising, int value)
+{
+    if (value < 0 || (value != 0) != rising)
+    {
+        reconciled = false;
+        return Edge::next;
+    }
+
+    /* The value read after an overflow already handled the edge the
+     * kernel reports late */
+    if (reconciled)
+    {
+        reconciled = false;
+        return Edge::handled;
+    }
+
+    gapCount++;
+    return Edge::gap;
+}
+
+bool GapDetector::read(bool full, bool pending)
+{
+    if (full && pending)
+    {
+        behind = true;
+        return false;
+    }
+
+    if (full || behind)
+    {
+        behind = false;
+        return true;
+    }
+
+    return false;
+}
+
+bool GapDetector::value(bool current, int value)
+{
+    if (value < 0 || (value != 0) == current)
+    {
+        return false;
+    }
+
+    gapCount++;
+    reconciled = true;
+    return true;
+}
+
+} // namespace gpio
+} // namespace phosphor
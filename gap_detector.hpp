@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <cstdint>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @class GapDetector
+ *  @brief Finds the edges the kernel dropped from the events of a line
+ *         requested for both edges.
+ *
+ *  Two edges of the same polarity mean the one between them was dropped.
+ *  An overflow of the kernel event FIFO drops the latest edges instead,
+ *  which only the line value read once the FIFO is drained tells. The
+ *  detector only takes the decisions, the monitor of the line reads the
+ *  events and the value.
+ */
+class GapDetector
+{
+  public:
+    /** @brief What to do with an edge read from the kernel */
+    enum class Edge
+    {
+        /** @brief Handle it */
+        next,
+        /** @brief Handle the dropped opposite edge first, then this one */
+        gap,
+        /** @brief Skip it, it was handled when the value was read */
+        handled,
+    };
+
+    /** @brief Checks an edge read from the kernel
+     *
+     *  @param[in] rising - whether it is a rising edge
+     *  @param[in] value  - line value before it, -1 if unknown
+     */
+    Edge edge(bool rising, int value);
+
+    /** @brief Notes a read of the kernel events
+     *
+     *  @param[in] full    - whether the read filled the event buffer, so
+     *                       the kernel FIFO may have overflowed
+     *  @param[in] pending - whether more events are left to read
+     *
+     *  @return true if the FIFO is drained after a possible overflow and
+     *          the line value has to be read now and passed to value()
+     */
+    bool read(bool full, bool pending);
+
+    /** @brief Checks the line value read after a possible overflow
+     *
+     *  @param[in] current - line value read
+     *  @param[in] value   - line value known from the events, -1 if
+     *                       unknown
+     *
+     *  @return true if the last edge was dropped and has to be handled,
+     *          the kernel may still report it when it raced with the read
+     */
+    bool value(bool current, int value);
+
+    /** @brief Forgets the reads, when the events are requested again */
+    void reset()
+    {
+        behind = false;
+        reconciled = false;
+    }
+
+    /** @brief Returns the number of edges the kernel dropped */
+    uint64_t gaps() const
+    {
+        return gapCount;
+    }
+
+  private:
+    uint64_t gapCount = 0;
+
+    /** @brief Whether a full read left events to read, so the line value
+     *         is read once they are drained */
+    bool behind = false;
+
+    /** @brief Whether the value read after an overflow is ahead of the
+     *         events */
+    bool reconciled = false;
+};
+
+} // namespace gpio
+} // namespace phosphor
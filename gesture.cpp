@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "gesture.hpp"
+
+namespace phosphor
+{
+namespace gpio
+{
+
+const char* gestureName(Gesture gesture)
+{
+    switch (gesture)
+    {
+        case Gesture::shortPress:
+            return "SHORT";
+        case Gesture::longPress:
+            return "LONG";
+        case Gesture::doublePress:
+            return "DOUBLE";
+    }
+
+    return "UNKNOWN";
+}
+
+void GestureRecognizer::edge(bool value, const timespec& ts)
+{
+    /* gpiod edge timestamps and std::chrono::steady_clock are both
+     * CLOCK_MONOTONIC, so the timers can be armed from kernel times */
+    auto time = std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::seconds(ts.tv_sec) +
+            std::chrono::nanoseconds(ts.tv_nsec)));
+
+    if (value != activeLow)
+    {
+        press(time);
+    }
+    else
+    {
+        release(time);
+    }
+}
+
+void GestureRecognizer::press(std::chrono::steady_clock::time_point time)
+{
+    switch (state)
+    {
+        case State::idle:
+            state = State::pressed;
+            break;
+        case State::waitSecond:
+            windowTimer.cancel();
+            /* The window timer had not run yet when the press came in late */
+            if (time - releaseTime > doublePress)
+            {
+                report(Gesture::shortPress, State::pressed);
+            }
+            else
+            {
+                state = State::pressedSecond;
+            }
+            break;
+        case State::pressed:
+        case State::pressedSecond:
+        case State::longHeld:
+            /* Release missed, restart from this press */
+            longTimer.cancel();
+            state = State::pressed;
+            break;
+    }
+
+    pressTime = time;
+    armLongPress(time);
+}
+
+void GestureRecognizer::release(std::chrono::steady_clock::time_point time)
+{
+    switch (state)
+    {
+        case State::idle:
+        case State::waitSecond:
+            /* Press missed, nothing to recognize */
+            return;
+        case State::longHeld:
+            state = State::idle;
+            return;
+        case State::pressed:
+        case State::pressedSecond:
+            break;
+    }
+
+    longTimer.cancel();
+
+    /* The long press timer had not run yet when the release came in */
+    if (time - pressTime >= longPress)
+    {
+        report(Gesture::longPress, State::idle);
+        return;
+    }
+
+    if (state == State::pressedSecond)
+    {
+        report(Gesture::doublePress, State::idle);
+        return;
+    }
+
+    if (doublePress.count() == 0)
+    {
+        report(Gesture::shortPress, State::idle);
+        return;
+    }
+
+    state = State::waitSecond;
+    releaseTime = time;
+    windowTimer.expires_at(time + doublePress);
+    windowTimer.async_wait([this](const boost::system::error_code& ec) {
+        /* A handler queued before the timer was re-armed sees a newer
+         * release time */
+        if (ec || state != State::waitSecond ||
+            std::chrono::steady_clock::now() - releaseTime < doublePress)
+        {
+            return;
+        }
+        report(Gesture::shortPress, State::idle);
+    });
+}
+
+void GestureRecognizer::armLongPress(std::chrono::steady_clock::time_point time)
+{
+    longTimer.expires_at(time + longPress);
+    longTimer.async_wait([this](const boost::system::error_code& ec) {
+        if (ec ||
+            (state != State::pressed && state != State::pressedSecond) ||
+            std::chrono::steady_clock::now() - pressTime < longPress)
+        {
+            return;
+        }
+        /* Still held, this also cancels a pending double press */
+        report(Gesture::longPress, State::longHeld);
+    });
+}
+
+void GestureRecognizer::report(Gesture gesture, State next)
+{
+    longTimer.cancel();
+    windowTimer.cancel();
+    state = next;
+    handler(gesture);
+}
+
+} // namespace gpio
+} // namespace phosphor
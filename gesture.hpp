@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <time.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <chrono>
+#include <functional>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+enum class Gesture
+{
+    shortPress,
+    longPress,
+    doublePress,
+};
+
+/** @brief Returns the config name of a gesture: SHORT, LONG or DOUBLE */
+const char* gestureName(Gesture gesture);
+
+/** @class GestureRecognizer
+ *  @brief Recognizes button gestures from the edges of a line.
+ *
+ *  Press durations come from the kernel edge timestamps, and one-shot
+ *  timers end a long press while the button is still held or a double
+ *  press window without a second press. Nothing is polled.
+ *
+ *  - A press released before the long press threshold is a short press,
+ *    reported once the double press window expired if double presses are
+ *    enabled.
+ *  - A press held for the long press threshold is a long press, reported
+ *    as soon as the threshold is reached. A pending double press is
+ *    cancelled.
+ *  - Two short presses with less than the window between the first release
+ *    and the second press are a double press.
+ */
+class GestureRecognizer
+{
+  public:
+    /** @brief Called when a gesture is recognized */
+    using Handler = std::function<void(Gesture gesture)>;
+
+    GestureRecognizer() = delete;
+    ~GestureRecognizer() = default;
+    GestureRecognizer(const GestureRecognizer&) = delete;
+    GestureRecognizer& operator=(const GestureRecognizer&) = delete;
+    GestureRecognizer(GestureRecognizer&&) = delete;
+    GestureRecognizer& operator=(GestureRecognizer&&) = delete;
+
+    /** @brief Constructs GestureRecognizer object.
+     *
+     *  @param[in] io          - io service running the timers
+     *  @param[in] longPress   - press duration making a long press
+     *  @param[in] doublePress - window for the second press of a double
+     *                           press, 0 disables double presses
+     *  @param[in] activeLow   - whether the button is pressed while the
+     *                           line is low
+     *  @param[in] handler     - called when a gesture is recognized
+     */
+    GestureRecognizer(boost::asio::io_context& io,
+                      std::chrono::milliseconds longPress,
+                      std::chrono::milliseconds doublePress, bool activeLow,
+                      Handler handler) :
+        longPress(longPress), doublePress(doublePress), activeLow(activeLow),
+        handler(std::move(handler)), longTimer(io), windowTimer(io)
+    {}
+
+    /** @brief Handles an edge of the line
+     *
+     *  @param[in] value - new line value
+     *  @param[in] ts    - kernel timestamp of the edge, CLOCK_MONOTONIC
+     */
+    void edge(bool value, const timespec& ts);
+
+  private:
+    enum class State
+    {
+        idle,
+        /** @brief First press is held */
+        pressed,
+        /** @brief First press released, waiting for a second one */
+        waitSecond,
+        /** @brief Second press of a double press is held */
+        pressedSecond,
+        /** @brief Long press reported, waiting for the release */
+        longHeld,
+    };
+
+    /** @brief Handles the button being pressed */
+    void press(std::chrono::steady_clock::time_point time);
+
+    /** @brief Handles the button being released */
+    void release(std::chrono::steady_clock::time_point time);
+
+    /** @brief Arms the long press timer for a press at the given time */
+    void armLongPress(std::chrono::steady_clock::time_point time);
+
+    /** @brief Reports a gesture and cancels anything pending */
+    void report(Gesture gesture, State next);
+
+    /** @brief Press duration making a long press */
+    const std::chrono::milliseconds longPress;
+
+    /** @brief Window for the second press, 0 disables double presses */
+    const std::chrono::milliseconds doublePress;
+
+    /** @brief Whether the button is pressed while the line is low */
+    const bool activeLow;
+
+    /** @brief Called when a gesture is recognized */
+    Handler handler;
+
+    State state = State::idle;
+
+    /** @brief Kernel time of the last press */
+    std::chrono::steady_clock::time_point pressTime;
+
+    /** @brief Kernel time of the last release */
+    std::chrono::steady_clock::time_point releaseTime;
+
+    /** @brief Fires when the current press becomes a long press */
+    boost::asio::steady_timer longTimer;
+
+    /** @brief Fires when the double press window expires */
+    boost::asio::steady_timer windowTimer;
+};
+
+} // namespace gpio
+} // namespace phosphor
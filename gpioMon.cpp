@@ -3,33 +3,81 @@
 
 #include "gpioMon.hpp"
 
+#include "event_journal.hpp"
+#include "loop_lag.hpp"
+#include "realtime.hpp"
+#include "startup.hpp"
+#include "trace.hpp"
+#include "units.hpp"
+
+#include <poll.h>
+
 #include <phosphor-logging/lg2.hpp>
-#include <sdbusplus/bus.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
 
 namespace phosphor
 {
 namespace gpio
 {
 
-/* systemd service to kick start a target. */
-constexpr auto SYSTEMD_SERVICE = "org.freedesktop.systemd1";
-constexpr auto SYSTEMD_ROOT = "/org/freedesktop/systemd1";
-constexpr auto SYSTEMD_INTERFACE = "org.freedesktop.systemd1.Manager";
-
 constexpr auto falling = "FALLING";
 constexpr auto rising = "RISING";
 constexpr auto init_high = "INIT_HIGH";
 constexpr auto init_low = "INIT_LOW";
 
+/** @brief Records an edge once its targets were started
+ *
+ *  Edges go to the binary event journal, the system journal is only used
+ *  when it could not be opened.
+ *
+ *  @param[in] journalId - id of the line in the event journal
+ *  @param[in] lineMsg   - GPIO line message used for log
+ *  @param[in] logLimit  - rate limiter of the line
+ *  @param[in] asserted  - whether the edge is rising
+ *  @param[in] ts        - kernel timestamp of the edge
+ *  @param[in] units     - number of targets started
+ *  @param[in] result    - result of the starts, -ECANCELED if they were
+ *                         dropped
+ */
+static void recordEdge(uint32_t journalId, const std::string& lineMsg,
+                       ratelimit::Limiter& logLimit, bool asserted,
+                       const timespec& ts, size_t units, int result)
+{
+    auto edge = asserted ? journal::Edge::rising : journal::Edge::falling;
+    auto count = static_cast<uint8_t>(std::min<size_t>(units, UINT8_MAX));
+    if (!journal::record(journalId, edge, ts, count, result))
+    {
+        if (asserted)
+        {
+            ratelimit::info(logLimit, "{GPIO} Asserted", "GPIO", lineMsg);
+        }
+        else
+        {
+            ratelimit::info(logLimit, "{GPIO} Deasserted", "GPIO", lineMsg);
+        }
+    }
+}
+
 void GpioMonitor::scheduleEventHandler()
 {
     gpioEventDescriptor.async_wait(
         boost::asio::posix::stream_descriptor::wait_read,
         [this](const boost::system::error_code& ec) {
+            if (ec == boost::asio::error::operation_aborted)
+            {
+                // we were cancelled, the monitor may be gone
+                return;
+            }
             if (ec)
             {
-                lg2::error("{GPIO} event handler error: {ERROR}", "GPIO",
-                           gpioLineMsg, "ERROR", ec.message());
+                ratelimit::error(logLimit,
+                                 "{GPIO} event handler error: {ERROR}", "GPIO",
+                                 gpioLineMsg, "ERROR", ec.message());
                 return;
             }
             gpioEventHandler();
@@ -38,99 +86,334 @@ void GpioMonitor::scheduleEventHandler()
 
 void GpioMonitor::gpioEventHandler()
 {
-    gpiod_line_event gpioLineEvent;
+    looplag::Scope scope("GPIO event", gpioLineMsg);
+    profile::Handler cost(profileId);
 
-    if (gpiod_line_event_read_fd(gpioEventDescriptor.native_handle(),
-                                 &gpioLineEvent) < 0)
+    /* Fast lines queue several events between two wakeups */
+    std::array<gpiod_line_event, maxEventsPerRead> gpioLineEvents;
+
+    bool bothEdges =
+        gpioConfig.request_type == GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES;
+    size_t total = 0;
+    for (size_t reads = 0; reads < maxReadsPerWakeup; reads++)
     {
-        lg2::error("Failed to read {GPIO} from fd", "GPIO", gpioLineMsg);
-        return;
+        int count = gpiod_line_event_read_fd_multiple(
+            gpioEventDescriptor.native_handle(), gpioLineEvents.data(),
+            gpioLineEvents.size());
+        if (count < 0)
+        {
+            ratelimit::error(logLimit, "Failed to read {GPIO} from fd",
+                             "GPIO", gpioLineMsg);
+            return;
+        }
+        GPIO_TRACE(event_batch, gpioLineMsg.c_str(), count);
+        total += count;
+
+        for (int i = 0; i < count; i++)
+        {
+            bool asserted =
+                gpioLineEvents[i].event_type == GPIOD_LINE_EVENT_RISING_EDGE;
+            if (bothEdges)
+            {
+                auto edge = gapDetector.edge(asserted, lineValue);
+                if (edge == GapDetector::Edge::handled)
+                {
+                    continue;
+                }
+                if (edge == GapDetector::Edge::gap)
+                {
+                    handleGap(!asserted, gpioLineEvents[i].ts);
+                }
+            }
+
+            handleEvent(gpioLineEvents[i]);
+
+            /* if not required to continue monitoring then return */
+            if (!continueAfterEvent)
+            {
+                return;
+            }
+        }
+
+        /* A full read may follow an overflow of the kernel event FIFO,
+         * which drops the latest edges. Once it is drained, the value
+         * tells whether the last edge was lost. */
+        bool full = static_cast<size_t>(count) == gpioLineEvents.size();
+        bool pending = full && eventsPending();
+        if (bothEdges && gapDetector.read(full, pending))
+        {
+            reconcile();
+        }
+        if (!pending)
+        {
+            break;
+        }
     }
 
-    if (gpioLineEvent.event_type == GPIOD_LINE_EVENT_RISING_EDGE)
+    /* Storming lines are sampled until they calm down */
+    if (storm && recordEdges &&
+        storm->edges(total, StormDetector::Clock::now()))
     {
-        lg2::info("{GPIO} Asserted", "GPIO", gpioLineMsg);
+        ratelimit::warning(
+            logLimit,
+            "{GPIO} is storming, polling it every {INTERVAL} ms, {COUNT} storms",
+            "GPIO", gpioLineMsg, "INTERVAL",
+            storm->settings().pollInterval.count(), "COUNT", storm->storms());
+        startStormPolling();
+        return;
     }
-    else
+
+    /* Schedule a wait event */
+    scheduleEventHandler();
+}
+
+void GpioMonitor::handleGap(bool value, const timespec& ts)
+{
+    ratelimit::warning(logLimit, "{GPIO} missed an edge, {COUNT} gaps", "GPIO",
+                       gpioLineMsg, "COUNT", gapDetector.gaps());
+
+    gpiod_line_event missed{};
+    missed.ts = ts;
+    missed.event_type = value ? GPIOD_LINE_EVENT_RISING_EDGE
+                              : GPIOD_LINE_EVENT_FALLING_EDGE;
+    handleEvent(missed);
+}
+
+bool GpioMonitor::eventsPending()
+{
+    pollfd pfd{gpioEventDescriptor.native_handle(), POLLIN, 0};
+    return poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN);
+}
+
+void GpioMonitor::reconcile()
+{
+    int value = gpiod_line_get_value(gpioLine);
+    if (value < 0 || !gapDetector.value(value != 0, lineValue))
     {
-        lg2::info("{GPIO} Deasserted", "GPIO", gpioLineMsg);
+        return;
     }
 
-    /* Execute the target if it is defined. */
-    if (!target.empty())
-    {
-        auto bus = sdbusplus::bus::new_default();
-        auto method = bus.new_method_call(SYSTEMD_SERVICE, SYSTEMD_ROOT,
-                                          SYSTEMD_INTERFACE, "StartUnit");
-        method.append(target);
-        method.append("replace");
+    /* An edge racing with the read is reported again by the kernel */
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    handleGap(value != 0, ts);
+}
 
-        bus.call_noreply(method);
-    }
+void GpioMonitor::startStormPolling()
+{
+    gapDetector.reset();
+
+    /* Releasing the events frees the interrupt of the line, libgpiod
+     * closes the descriptor */
+    gpioEventDescriptor.release();
+    gpiod_line_release(gpioLine);
 
-    std::vector<std::string> targetsToStart;
-    if (gpioLineEvent.event_type == GPIOD_LINE_EVENT_RISING_EDGE)
+    if (gpiod_line_request_input_flags(gpioLine, gpioConfig.consumer,
+                                       gpioConfig.flags) < 0)
     {
-        auto risingFind = targets.find(rising);
-        if (risingFind != targets.end())
+        lg2::error("Failed to request storming {GPIO} as input: {ERROR}",
+                   "GPIO", gpioLineMsg, "ERROR", strerror(errno));
+        requestGPIOEvents();
+        return;
+    }
+
+    scheduleStormPoll();
+}
+
+void GpioMonitor::scheduleStormPoll()
+{
+    stormTimer.expires_after(storm->settings().pollInterval);
+    stormTimer.async_wait([this](const boost::system::error_code& ec) {
+        if (ec)
         {
-            targetsToStart = risingFind->second;
+            // we were cancelled, the monitor may be gone
+            return;
         }
-    }
-    else
-    {
-        auto fallingFind = targets.find(falling);
-        if (fallingFind != targets.end())
+
+        looplag::Scope scope("GPIO storm poll", gpioLineMsg);
+        profile::Handler cost(profileId);
+        int value = gpiod_line_get_value(gpioLine);
+        if (value < 0)
+        {
+            ratelimit::error(logLimit, "Failed to read {GPIO}: {ERROR}",
+                             "GPIO", gpioLineMsg, "ERROR", strerror(errno));
+            scheduleStormPoll();
+            return;
+        }
+
+        bool changed = lineValue != (value != 0);
+        if (changed)
+        {
+            timespec ts{};
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            pollEvent(value != 0, ts);
+        }
+
+        if (!storm->sample(changed, StormDetector::Clock::now()))
         {
-            targetsToStart = fallingFind->second;
+            scheduleStormPoll();
+            return;
         }
+
+        lg2::info("{GPIO} quiet for {QUIET} ms, requesting edge events again",
+                  "GPIO", gpioLineMsg, "QUIET",
+                  storm->settings().quietTime.count());
+        gpiod_line_release(gpioLine);
+
+        /* A busy line is requested again when its consumer releases it */
+        if (requestGPIOEvents() == 0 && polling)
+        {
+            polling = false;
+            startStormPolling();
+        }
+    });
+}
+
+void GpioMonitor::handleEvent(const gpiod_line_event& gpioLineEvent)
+{
+    realtime::recordLatency(CLOCK_MONOTONIC, gpioLineEvent.ts);
+
+    bool asserted = gpioLineEvent.event_type == GPIOD_LINE_EVENT_RISING_EDGE;
+    GPIO_TRACE(event_read, gpioLineMsg.c_str(), asserted,
+               traceNs(gpioLineEvent.ts));
+    lineValue = asserted;
+    linestate::edge(stateId, asserted, gpioLineEvent.ts);
+    timeline::record(timelineId, asserted, gpioLineEvent.ts);
+
+    for (auto& callback : reflexCallbacks)
+    {
+        callback(asserted, gpioLineEvent.ts);
     }
 
-    /* Execute the multi targets if it is defined. */
-    if (!targetsToStart.empty())
+    if (recordEdges)
     {
-        auto bus = sdbusplus::bus::new_default();
-        for (auto& tar : targetsToStart)
+        std::vector<std::string> targetsToStart;
+        if (asserted)
+        {
+            auto risingFind = targets.find(rising);
+            if (risingFind != targets.end())
+            {
+                targetsToStart = risingFind->second;
+            }
+        }
+        else
+        {
+            auto fallingFind = targets.find(falling);
+            if (fallingFind != targets.end())
+            {
+                targetsToStart = fallingFind->second;
+            }
+        }
+
+        /* Execute the target and the multi targets if they are defined. */
+        if (!target.empty())
+        {
+            targetsToStart.insert(targetsToStart.begin(), target);
+        }
+
+        if (actionQueue == nullptr || targetsToStart.empty())
+        {
+            int result =
+                startUnits(targetsToStart, logLimit, gpioLineEvent.ts);
+            recordEdge(journalId, gpioLineMsg, logLimit, asserted,
+                       gpioLineEvent.ts, targetsToStart.size(), result);
+        }
+        else
         {
-            auto method = bus.new_method_call(SYSTEMD_SERVICE, SYSTEMD_ROOT,
-                                              SYSTEMD_INTERFACE, "StartUnit");
-            method.append(tar, "replace");
-            bus.call_noreply(method);
+            std::string key;
+            for (const auto& unit : targetsToStart)
+            {
+                key += key.empty() ? unit : " " + unit;
+            }
+
+            /* The monitor may be gone when the action runs */
+            actionQueue->push(
+                gpioLineMsg, profileId, key,
+                [targets = std::move(targetsToStart), id = journalId,
+                 lineMsg = gpioLineMsg, &limiter = logLimit, asserted,
+                 ts = gpioLineEvent.ts](bool run) {
+                    int result =
+                        run ? startUnits(targets, limiter, ts) : -ECANCELED;
+                    recordEdge(id, lineMsg, limiter, asserted, ts,
+                               targets.size(), result);
+                });
         }
     }
 
-    /* if not required to continue monitoring then return */
-    if (!continueAfterEvent)
+    for (auto& callback : edgeCallbacks)
     {
-        return;
+        callback(asserted, gpioLineEvent.ts);
     }
-
-    /* Schedule a wait event */
-    scheduleEventHandler();
 }
 
 void GpioMonitor::gpioHandleInitialState(bool value)
 {
+    startup::Phase dispatch("initial dispatch");
     if (auto itr = targets.find(value ? init_high : init_low);
         itr != targets.end())
     {
-        auto bus = sdbusplus::bus::new_default();
-        for (const auto& tar : itr->second)
-        {
-            auto method = bus.new_method_call(SYSTEMD_SERVICE, SYSTEMD_ROOT,
-                                              SYSTEMD_INTERFACE, "StartUnit");
-            method.append(tar, "replace");
-            bus.call_noreply(method);
-        }
+        startUnits(itr->second, logLimit);
     }
 }
 
+void GpioMonitor::pollEvent(bool value, const timespec& ts)
+{
+    profile::Handler cost(profileId);
+
+    if (lineValue < 0)
+    {
+        lineValue = value;
+        linestate::setValue(stateId, value);
+        gpioHandleInitialState(value);
+        return;
+    }
+
+    if (stopped ||
+        (value && gpioConfig.request_type ==
+                      GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE) ||
+        (!value &&
+         gpioConfig.request_type == GPIOD_LINE_REQUEST_EVENT_RISING_EDGE))
+    {
+        GPIO_TRACE(event_filtered, gpioLineMsg.c_str(), value);
+        lineValue = value;
+        linestate::edge(stateId, value, ts);
+        return;
+    }
+
+    gpiod_line_event gpioLineEvent{};
+    gpioLineEvent.ts = ts;
+    gpioLineEvent.event_type = value ? GPIOD_LINE_EVENT_RISING_EDGE
+                                     : GPIOD_LINE_EVENT_FALLING_EDGE;
+    handleEvent(gpioLineEvent);
+
+    stopped = !continueAfterEvent;
+}
+
 int GpioMonitor::requestGPIOEvents()
 {
     /* Request an event to monitor for respected gpio line */
     if (gpiod_line_request(gpioLine, &gpioConfig, 0) < 0)
     {
-        lg2::error("Failed to request {GPIO}", "GPIO", gpioLineMsg);
+        /* Lines of expanders without an interrupt cannot deliver events,
+         * the kernel reports the missing interrupt as ENODEV or ENXIO */
+        if (errno == ENODEV || errno == ENXIO || errno == EOPNOTSUPP)
+        {
+            lg2::info("Failed to request events of {GPIO}: {ERROR}, polling it",
+                      "GPIO", gpioLineMsg, "ERROR", strerror(errno));
+            polling = true;
+            return 0;
+        }
+
+        if (errno != EBUSY)
+        {
+            lg2::error("Failed to request events of {GPIO}: {ERROR}", "GPIO",
+                       gpioLineMsg, "ERROR", strerror(errno));
+            return -1;
+        }
+
+        /* Requested again when the other consumer releases it */
+        lg2::warning("{GPIO} is used by another consumer, waiting for it",
+                     "GPIO", gpioLineMsg);
         return -1;
     }
 
@@ -147,10 +430,19 @@ int GpioMonitor::requestGPIOEvents()
         lg2::error("Failed to get value for {GPIO} Error: {ERROR}", "GPIO",
                    gpioLineMsg, "ERROR", strerror(errno));
     }
-    else
+    else if (lineValue < 0)
     {
+        lineValue = value != 0;
+        linestate::setValue(stateId, lineValue);
         gpioHandleInitialState(value != 0);
     }
+    else if (lineValue != (value != 0))
+    {
+        /* Changed while the events were released during a storm */
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        pollEvent(value != 0, ts);
+    }
 
     lg2::info("{GPIO} monitoring started", "GPIO", gpioLineMsg);
 
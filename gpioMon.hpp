@@ -3,12 +3,24 @@
 
 #pragma once
 
+#include "action_queue.hpp"
+#include "event_journal.hpp"
+#include "gap_detector.hpp"
+#include "line_profile.hpp"
+#include "line_state.hpp"
+#include "ratelimit.hpp"
+#include "storm.hpp"
+#include "timeline.hpp"
+
 #include <gpiod.h>
 
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/posix/stream_descriptor.hpp>
+#include <boost/asio/steady_timer.hpp>
 
+#include <functional>
 #include <map>
+#include <optional>
 #include <vector>
 
 namespace phosphor
@@ -23,8 +35,17 @@ namespace gpio
 class GpioMonitor
 {
   public:
+    /** @brief Called with the new line value on every edge */
+    using EdgeCallback = std::function<void(bool value, const timespec& ts)>;
+
     GpioMonitor() = delete;
-    ~GpioMonitor() = default;
+    ~GpioMonitor()
+    {
+        /* The descriptor belongs to libgpiod, which closes it with the
+         * chip */
+        gpioEventDescriptor.release();
+        linestate::setValue(stateId, -1);
+    }
     GpioMonitor(const GpioMonitor&) = delete;
     GpioMonitor& operator=(const GpioMonitor&) = delete;
     GpioMonitor(GpioMonitor&&) = delete;
@@ -41,19 +62,127 @@ class GpioMonitor
      *                           value change
      *  @param[in] lineMsg     - GPIO line message to be used for log
      *  @param[in] continueRun - Whether to continue after event occur
+     *  @param[in] logLimits   - rate limits of the log messages of the line
+     *  @param[in] poll        - Whether to poll the line instead of
+     *                           requesting edge events
      */
     GpioMonitor(gpiod_line* line, gpiod_line_request_config& config,
                 boost::asio::io_context& io, const std::string& target,
                 const std::map<std::string, std::vector<std::string>>& targets,
-                const std::string& lineMsg, bool continueRun) :
+                const std::string& lineMsg, bool continueRun,
+                const ratelimit::Limits& logLimits, bool poll) :
         gpioLine(line), gpioConfig(config), gpioEventDescriptor(io),
-        target(target), targets(targets), gpioLineMsg(lineMsg),
-        continueAfterEvent(continueRun)
+        stormTimer(io), target(target), targets(targets), gpioLineMsg(lineMsg),
+        journalId(journal::addLine(lineMsg)),
+        profileId(profile::addLine(lineMsg)),
+        timelineId(timeline::addLine(lineMsg)),
+        stateId(linestate::addLine(lineMsg)),
+        logLimit(ratelimit::get(lineMsg, logLimits)),
+        continueAfterEvent(continueRun), polling(poll)
     {
-        requestGPIOEvents();
+        if (!polling)
+        {
+            requestGPIOEvents();
+        }
     };
 
+    /** @brief Returns the last known line value, -1 if it is unknown */
+    int value() const
+    {
+        return lineValue;
+    }
+
+    /** @brief Registers a callback run on every edge, after the targets
+     *
+     *  @param[in] callback - called with the new line value
+     */
+    void addEdgeCallback(EdgeCallback&& callback)
+    {
+        edgeCallbacks.push_back(std::move(callback));
+    }
+
+    /** @brief Registers a callback run on every edge before the targets,
+     *         for reflexes which cannot wait for them
+     *
+     *  @param[in] callback - called with the new line value
+     */
+    void addReflexCallback(EdgeCallback&& callback)
+    {
+        reflexCallbacks.push_back(std::move(callback));
+    }
+
+    /** @brief Returns whether the line has to be polled, either because it
+     *         was asked for or because it cannot deliver edge events
+     */
+    bool polled() const
+    {
+        return polling;
+    }
+
+    /** @brief Requests the line again after another consumer released it,
+     *         unless it is requested or polled already
+     */
+    void retryRequest()
+    {
+        if (!polling && !gpiod_line_is_requested(gpioLine))
+        {
+            requestGPIOEvents();
+        }
+    }
+
+    /** @brief Handles a value read by the poller of the line
+     *
+     *  The first value is handled as the initial state, a change as an edge
+     *  if its type is monitored.
+     *
+     *  @param[in] value - line value
+     *  @param[in] ts    - CLOCK_MONOTONIC time of the read
+     */
+    void pollEvent(bool value, const timespec& ts);
+
+    /** @brief Sets whether edges start the targets and are journaled.
+     *
+     *  Measured lines only feed their edge callbacks.
+     */
+    void setRecordEdges(bool record)
+    {
+        recordEdges = record;
+    }
+
+    /** @brief Queues the targets started by edges instead of starting them
+     *         from the event handler
+     *
+     *  @param[in] queue - action queue of the daemon
+     */
+    void setActionQueue(ActionQueue* queue)
+    {
+        actionQueue = queue;
+    }
+
+    /** @brief Polls the line while its edges come in faster than a rate,
+     *         instead of taking an interrupt per edge
+     *
+     *  Measured lines are always serviced by their edge events.
+     *
+     *  @param[in] config - storm rate and polling parameters
+     */
+    void setStormConfig(const StormDetector::Config& config)
+    {
+        if (config.rate > 0)
+        {
+            storm.emplace(config);
+        }
+    }
+
   private:
+    /** @brief Maximum number of events read at once, the size of the
+     *         kernel event FIFO */
+    static constexpr size_t maxEventsPerRead = 16;
+
+    /** @brief Maximum number of reads on one wakeup, a line with events
+     *         left wakes the loop up again */
+    static constexpr size_t maxReadsPerWakeup = 4;
+
     /** @brief GPIO line */
     gpiod_line* gpioLine;
 
@@ -63,6 +192,9 @@ class GpioMonitor
     /** @brief GPIO event descriptor */
     boost::asio::posix::stream_descriptor gpioEventDescriptor;
 
+    /** @brief Samples the line during a storm */
+    boost::asio::steady_timer stormTimer;
+
     /** @brief Systemd unit to be started when the condition is met */
     const std::string target;
 
@@ -72,9 +204,51 @@ class GpioMonitor
     /** @brief GPIO line name message */
     std::string gpioLineMsg;
 
+    /** @brief Id of the line in the event journal */
+    uint32_t journalId;
+
+    /** @brief Id of the line in the handler profile */
+    uint32_t profileId;
+
+    /** @brief Id of the line in the edge timeline */
+    uint32_t timelineId;
+
+    /** @brief Id of the line in the shared line state table */
+    uint32_t stateId;
+
+    /** @brief Rate limiter of the hot path log messages */
+    ratelimit::Limiter& logLimit;
+
     /** @brief If the monitor should continue after event */
     bool continueAfterEvent;
 
+    /** @brief Whether the line is polled instead of delivering events */
+    bool polling;
+
+    /** @brief Whether the monitor stopped after its first event */
+    bool stopped = false;
+
+    /** @brief Whether edges start the targets and are journaled */
+    bool recordEdges = true;
+
+    /** @brief Last known line value, -1 if it is unknown */
+    int lineValue = -1;
+
+    /** @brief Queue of the targets started by edges, if any */
+    ActionQueue* actionQueue = nullptr;
+
+    /** @brief Finds the edges the kernel dropped */
+    GapDetector gapDetector;
+
+    /** @brief Storm detection of the line, if enabled */
+    std::optional<StormDetector> storm;
+
+    /** @brief Callbacks run on every edge */
+    std::vector<EdgeCallback> edgeCallbacks;
+
+    /** @brief Callbacks run on every edge before the targets */
+    std::vector<EdgeCallback> reflexCallbacks;
+
     /** @brief register handler for gpio event
      *
      *  @return  - 0 on success and -1 otherwise
@@ -84,9 +258,32 @@ class GpioMonitor
     /** @brief Schedule an event handler for GPIO event to trigger */
     void scheduleEventHandler();
 
-    /** @brief Handle the GPIO event and starts configured target */
+    /** @brief Reads the pending GPIO events and handles them */
     void gpioEventHandler();
 
+    /** @brief Handles an edge the kernel dropped
+     *
+     *  @param[in] value - line value after the missed edge
+     *  @param[in] ts    - time the missed edge was noticed at
+     */
+    void handleGap(bool value, const timespec& ts);
+
+    /** @brief Returns whether events are left to read, without blocking */
+    bool eventsPending();
+
+    /** @brief Reads the line value, handling a change the events missed */
+    void reconcile();
+
+    /** @brief Releases the edge events of a storming line and polls it */
+    void startStormPolling();
+
+    /** @brief Samples a storming line, requesting its edge events again
+     *         once it is quiet */
+    void scheduleStormPoll();
+
+    /** @brief Handle the GPIO event and starts configured target */
+    void handleEvent(const gpiod_line_event& gpioLineEvent);
+
     /** @brief handle current gpio value */
     void gpioHandleInitialState(bool value);
 };
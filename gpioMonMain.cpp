@@ -1,20 +1,53 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 
+#include "action_queue.hpp"
+#include "chip_watch.hpp"
+#include "conditions.hpp"
+#include "config_line.hpp"
+#include "dbus_action.hpp"
+#include "event_journal.hpp"
+#include "exec_action.hpp"
+#include "gesture.hpp"
 #include "gpioMon.hpp"
+#include "line_object.hpp"
+#include "line_profile.hpp"
+#include "line_state.hpp"
+#include "line_watch.hpp"
+#include "loop_lag.hpp"
+#include "measure.hpp"
+#include "output.hpp"
+#include "poller.hpp"
+#include "ratelimit.hpp"
+#include "realtime.hpp"
+#include "snapshot.hpp"
+#include "startup.hpp"
+#include "storm.hpp"
+#include "timeline.hpp"
+#include "units.hpp"
 
 #include <CLI/CLI.hpp>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <nlohmann/json.hpp>
 #include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/asio/connection.hpp>
+#include <sdbusplus/asio/object_server.hpp>
 
+#include <algorithm>
 #include <fstream>
+#include <functional>
+#include <optional>
 
 namespace phosphor
 {
 namespace gpio
 {
 
+/** @brief Bus name requested when lines are published on D-Bus */
+constexpr auto busName = "xyz.openbmc_project.GPIO.Monitor";
+
 std::map<std::string, int> polarityMap = {
     /**< Only watch falling edge events. */
     {"FALLING", GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE},
@@ -23,6 +56,504 @@ std::map<std::string, int> polarityMap = {
     /**< Monitor both types of events. */
     {"BOTH", GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES}};
 
+/** @brief Output lines of the config file, by GPIO line message */
+using Outputs = std::map<std::string, std::unique_ptr<OutputLine>>;
+
+/** @brief Adds a condition entry of the config file to the engine
+ *
+ *  @return false if the entry is invalid
+ */
+bool addCondition(ConditionEngine& engine, const nlohmann::json& obj)
+{
+    if (obj.find("Name") == obj.end())
+    {
+        lg2::error("Condition name not specified: {CONDITION}", "CONDITION",
+                   obj["Condition"].get<std::string>());
+        return false;
+    }
+
+    auto name = obj["Name"].get<std::string>();
+    auto hold = std::chrono::milliseconds(obj.value("HoldMs", 0));
+    auto triggers = obj.value("Trigger", std::vector<std::string>());
+    auto targets = obj.value("Targets",
+                             std::map<std::string, std::vector<std::string>>());
+
+    try
+    {
+        auto& logLimit =
+            ratelimit::get("Condition " + name, ratelimit::parse(obj));
+        engine.addCondition(
+            name, obj["Condition"].get<std::string>(), hold, triggers,
+            [targets = std::move(targets), &logLimit](bool state) {
+                if (auto itr = targets.find(state ? "TRUE" : "FALSE");
+                    itr != targets.end())
+                {
+                    startUnits(itr->second, logLimit);
+                }
+            });
+    }
+    catch (const std::invalid_argument& e)
+    {
+        lg2::error("Invalid condition {NAME}: {ERROR}", "NAME", name, "ERROR",
+                   e);
+        return false;
+    }
+
+    return true;
+}
+
+/** @brief Creates the gesture recognizer of a line entry of the config file
+ *
+ *  @param[in] io        - io service running the gesture timers
+ *  @param[in] obj       - "Gestures" object of the line entry
+ *  @param[in] lineMsg   - GPIO line message used for log
+ *  @param[in] logLimits - log rate limits of the line entry
+ */
+std::unique_ptr<GestureRecognizer> makeGestures(
+    boost::asio::io_context& io, const nlohmann::json& obj,
+    const std::string& lineMsg, const ratelimit::Limits& logLimits)
+{
+    auto longPress = std::chrono::milliseconds(obj.value("LongPressMs", 2000));
+    auto doublePress =
+        std::chrono::milliseconds(obj.value("DoublePressMs", 0));
+    auto activeLow = obj.value("ActiveLow", true);
+    auto targets = obj.value("Targets",
+                             std::map<std::string, std::vector<std::string>>());
+    auto& logLimit = ratelimit::get(lineMsg, logLimits);
+
+    return std::make_unique<GestureRecognizer>(
+        io, longPress, doublePress, activeLow,
+        [targets = std::move(targets), &logLimit,
+         lineMsg](Gesture gesture) {
+            ratelimit::info(logLimit, "{GPIO} {GESTURE} press", "GPIO",
+                            lineMsg, "GESTURE", gestureName(gesture));
+
+            if (auto itr = targets.find(gestureName(gesture));
+                itr != targets.end())
+            {
+                startUnits(itr->second, logLimit);
+            }
+        });
+}
+
+/** @brief Creates the measurement of a line entry of the config file
+ *
+ *  @param[in] io        - io service running the publish timer
+ *  @param[in] server    - object server hosting the measurement
+ *  @param[in] obj       - "Measure" object of the line entry
+ *  @param[in] name      - name of the line entry
+ *  @param[in] lineMsg   - GPIO line message used for log
+ *  @param[in] logLimits - log rate limits of the line entry
+ *
+ *  @return nullptr if the entry is invalid
+ */
+std::unique_ptr<LineMeasure> makeMeasure(
+    boost::asio::io_context& io, sdbusplus::asio::object_server& server,
+    const nlohmann::json& obj, const std::string& name,
+    const std::string& lineMsg, const ratelimit::Limits& logLimits)
+{
+    auto window = std::chrono::milliseconds(obj.value("WindowMs", 1000));
+    auto interval = std::chrono::milliseconds(obj.value("IntervalMs", 1000));
+    auto maxEdges = obj.value("MaxEdges", nlohmann::json(4096));
+    auto targets = obj.value("Targets",
+                             std::map<std::string, std::vector<std::string>>());
+
+    LineMeasure::Threshold threshold;
+    if (obj.find("Threshold") != obj.end())
+    {
+        const auto& thresholdObj = obj["Threshold"];
+        threshold.metric = thresholdObj.value("Metric", "Frequency");
+        if (thresholdObj.find("Low") != thresholdObj.end())
+        {
+            threshold.low = thresholdObj["Low"].get<double>();
+        }
+        if (thresholdObj.find("High") != thresholdObj.end())
+        {
+            threshold.high = thresholdObj["High"].get<double>();
+        }
+    }
+
+    if (interval.count() <= 0 || window.count() <= 0)
+    {
+        lg2::error("{GPIO}: measure window and interval must be positive",
+                   "GPIO", lineMsg);
+        return nullptr;
+    }
+
+    if (!maxEdges.is_number_unsigned() || maxEdges.get<uint64_t>() == 0)
+    {
+        lg2::error("{GPIO}: MaxEdges must be a positive integer", "GPIO",
+                   lineMsg);
+        return nullptr;
+    }
+    auto capacity = std::max<size_t>(maxEdges.get<uint64_t>(), 2);
+
+    try
+    {
+        return std::make_unique<LineMeasure>(
+            io, server, name, window, interval, capacity, threshold, targets,
+            ratelimit::get(lineMsg, logLimits));
+    }
+    catch (const std::invalid_argument& e)
+    {
+        lg2::error("{GPIO}: invalid measure threshold: {ERROR}", "GPIO",
+                   lineMsg, "ERROR", e);
+        return nullptr;
+    }
+}
+
+/** @brief Output driven by the edges of a line entry */
+struct OutputAction
+{
+    OutputLine* output;
+    OutputLine::Action action;
+    /** @brief Edge type running the action */
+    int edge;
+    std::chrono::microseconds width;
+    /** @brief Whether the pulse is timed in the event handler */
+    bool blocking;
+};
+
+/** @brief Returns the output line of an output action of the config file,
+ *         requesting it the first time
+ *
+ *  @param[in] io      - io service running the pulse timers
+ *  @param[in] outputs - output lines requested so far
+ *  @param[in] obj     - output action object of a line entry
+ *
+ *  @return nullptr if the line could not be found or requested
+ */
+OutputLine* getOutput(boost::asio::io_context& io, Outputs& outputs,
+                      const nlohmann::json& obj)
+{
+    gpiod_line* line = nullptr;
+    std::string lineMsg = "GPIO Line ";
+    if (obj.find("LineName") != obj.end())
+    {
+        auto name = obj["LineName"].get<std::string>();
+        lineMsg += name;
+        if (auto itr = outputs.find(lineMsg); itr != outputs.end())
+        {
+            return itr->second.get();
+        }
+        line = gpiod_line_find(name.c_str());
+    }
+    else if (obj.find("ChipId") != obj.end() &&
+             obj.find("GpioNum") != obj.end())
+    {
+        auto chipId = obj["ChipId"].get<std::string>();
+        auto gpioNum = obj["GpioNum"].get<int>();
+        lineMsg += chipId + " " + std::to_string(gpioNum);
+        if (auto itr = outputs.find(lineMsg); itr != outputs.end())
+        {
+            return itr->second.get();
+        }
+        line = gpiod_line_get(chipId.c_str(), gpioNum);
+    }
+    else
+    {
+        lg2::error("Output without line name or gpio number");
+        return nullptr;
+    }
+
+    if (line == nullptr)
+    {
+        lg2::error("Failed to find the output {GPIO}", "GPIO", lineMsg);
+        return nullptr;
+    }
+
+    auto output = std::make_unique<OutputLine>(io, lineMsg);
+    int flags = obj.value("ActiveLow", false)
+                    ? GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW
+                    : 0;
+    if (output->request(line, flags, obj.value("InitialValue", 0)) < 0)
+    {
+        return nullptr;
+    }
+
+    return (outputs[lineMsg] = std::move(output)).get();
+}
+
+/** @brief Parses the "Outputs" array of a line entry
+ *
+ *  @param[in] io      - io service running the pulse timers
+ *  @param[in] outputs - output lines requested so far
+ *  @param[in] obj     - "Outputs" array of the line entry
+ *  @param[in] lineMsg - GPIO line message used for log
+ *
+ *  @return nullopt if an output action is invalid
+ */
+std::optional<std::vector<OutputAction>> makeOutputActions(
+    boost::asio::io_context& io, Outputs& outputs, const nlohmann::json& obj,
+    const std::string& lineMsg)
+{
+    std::vector<OutputAction> actions;
+
+    for (const auto& outputObj : obj)
+    {
+        auto actionStr = outputObj.value("Action", "");
+        auto action = OutputLine::parseAction(actionStr);
+        if (!action)
+        {
+            lg2::error("{GPIO}: unknown output action {ACTION}", "GPIO",
+                       lineMsg, "ACTION", actionStr);
+            return std::nullopt;
+        }
+
+        auto edge = polarityMap.find(outputObj.value("Edge", "BOTH"));
+        if (edge == polarityMap.end())
+        {
+            lg2::error("{GPIO}: unknown output edge", "GPIO", lineMsg);
+            return std::nullopt;
+        }
+
+        auto pulseUs = outputObj.value("PulseUs", nlohmann::json(1000));
+        if (!pulseUs.is_number_unsigned() || pulseUs.get<uint64_t>() == 0)
+        {
+            lg2::error("{GPIO}: PulseUs must be a positive integer", "GPIO",
+                       lineMsg);
+            return std::nullopt;
+        }
+        std::chrono::microseconds width(pulseUs.get<uint64_t>());
+
+        /* Blocking the event handler is only worth it for pulses the event
+         * loop cannot time */
+        bool blocking = outputObj.value("Blocking", false);
+        if (blocking && (*action != OutputLine::Action::pulse ||
+                         width > OutputLine::maxBlockingPulse))
+        {
+            lg2::error("{GPIO}: only pulses up to {MAX_US} us can block",
+                       "GPIO", lineMsg, "MAX_US",
+                       OutputLine::maxBlockingPulse.count());
+            return std::nullopt;
+        }
+
+        auto* output = getOutput(io, outputs, outputObj);
+        if (output == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        /* A mirror follows both edges whatever its edge type */
+        actions.push_back(
+            {output, *action,
+             *action == OutputLine::Action::mirror
+                 ? GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES
+                 : edge->second,
+             width, blocking});
+    }
+
+    return actions;
+}
+
+/** @brief Timeline dump armed by a trigger edge */
+struct TimelineDump
+{
+    TimelineDump(boost::asio::io_context& io, const std::string& dir) :
+        timer(io), dir(dir)
+    {}
+
+    /** @brief Dumps the timeline once the edges following a trigger edge
+     *         were recorded too, a trigger while a dump is pending is
+     *         part of it
+     *
+     *  @param[in] lineMsg - GPIO line message of the trigger edge
+     *  @param[in] post    - time recorded after the trigger edge
+     */
+    void trigger(const std::string& lineMsg, std::chrono::milliseconds post)
+    {
+        if (pending)
+        {
+            return;
+        }
+        pending = true;
+
+        lg2::info("{GPIO} triggered a timeline dump", "GPIO", lineMsg);
+
+        timer.expires_after(post);
+        timer.async_wait([this](const boost::system::error_code& ec) {
+            pending = false;
+            if (!ec)
+            {
+                timeline::dump(dir);
+            }
+        });
+    }
+
+    boost::asio::steady_timer timer;
+    const std::string dir;
+    bool pending = false;
+};
+
+/** @brief Dumps the timeline on every timeline dump signal */
+void scheduleTimelineDump(boost::asio::signal_set& signals,
+                          const std::string& dir)
+{
+    signals.async_wait(
+        [&signals, &dir](const boost::system::error_code& ec, int) {
+            if (ec)
+            {
+                return;
+            }
+            timeline::dump(dir);
+            scheduleTimelineDump(signals, dir);
+        });
+}
+
+/** @brief A line entry of the config file */
+struct LineEntry : public ConfigLine
+{
+    bool continueRun = false;
+    bool poll = false;
+    std::string target;
+    std::map<std::string, std::vector<std::string>> targets;
+    ratelimit::Limits logLimits;
+
+    /** @brief Index of the line in the condition engine, if it has a name */
+    std::optional<size_t> conditionIndex;
+    std::unique_ptr<GestureRecognizer> gestures;
+    std::unique_ptr<LineMeasure> measure;
+
+    /** @brief D-Bus object publishing the line state, named objectName */
+    std::string objectName;
+    std::unique_ptr<LineObject> object;
+
+    /** @brief Edge type dumping the timeline, 0 for none, and the time
+     *         recorded after it */
+    int timelineTrigger = 0;
+    std::chrono::milliseconds timelinePost{0};
+    TimelineDump* timelineDump = nullptr;
+
+    /** @brief Queue of the targets started by edges */
+    ActionQueue* actionQueue = nullptr;
+
+    /** @brief Edge rate switching the line to polling */
+    StormDetector::Config stormConfig;
+
+    /** @brief Outputs driven directly by the edges */
+    std::vector<OutputAction> outputs;
+
+    /** @brief Property sets and method calls by edge type, RISING or
+     *         FALLING, made on the connection */
+    std::map<std::string, std::vector<DBusAction>> dbusActions;
+    sdbusplus::asio::connection* conn = nullptr;
+
+    /** @brief Programs run by edge type, RISING or FALLING */
+    std::map<std::string, std::vector<std::unique_ptr<ExecAction>>> execActions;
+
+    /** @brief Monitor of the line, set while the line is acquired */
+    std::unique_ptr<GpioMonitor> gpio;
+};
+
+/** @brief Starts monitoring the line of an entry once it is found */
+void startMonitor(LineEntry& entry, boost::asio::io_context& io,
+                  ConditionEngine& conditions)
+{
+    auto& gpio = entry.gpio = std::make_unique<GpioMonitor>(
+        entry.line, entry.config, io, entry.target, entry.targets,
+        entry.lineMsg, entry.continueRun, entry.logLimits, entry.poll);
+    gpio->setActionQueue(entry.actionQueue);
+    gpio->setStormConfig(entry.stormConfig);
+
+    /* Outputs are driven before anything else is done for the edge */
+    for (const auto& output : entry.outputs)
+    {
+        gpio->addReflexCallback([output](bool value, const timespec& ts) {
+            if (output.edge == GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES ||
+                output.edge == (value ? GPIOD_LINE_REQUEST_EVENT_RISING_EDGE
+                                      : GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE))
+            {
+                output.output->run(output.action, output.width,
+                                   output.blocking, value, ts);
+            }
+        });
+    }
+
+    gpio->addEdgeCallback(
+        [object = entry.object.get()](bool value, const timespec& ts) {
+            object->edge(value, ts);
+        });
+
+    /* Feed the line state to the conditions referring to its name */
+    if (entry.conditionIndex)
+    {
+        gpio->addEdgeCallback(
+            [&conditions, index = *entry.conditionIndex](bool value,
+                                                         const timespec&) {
+                conditions.setLine(index, value);
+            });
+    }
+
+    /* Recognize button gestures from the edges of the line */
+    if (entry.gestures)
+    {
+        gpio->addEdgeCallback(
+            [recognizer = entry.gestures.get()](bool value,
+                                                const timespec& ts) {
+                recognizer->edge(value, ts);
+            });
+    }
+
+    /* Dump the timeline around the trigger edges of the line */
+    if (entry.timelineTrigger)
+    {
+        gpio->addEdgeCallback([&entry](bool value, const timespec&) {
+            if (entry.timelineTrigger == GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES ||
+                entry.timelineTrigger ==
+                    (value ? GPIOD_LINE_REQUEST_EVENT_RISING_EDGE
+                           : GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE))
+            {
+                entry.timelineDump->trigger(entry.lineMsg, entry.timelinePost);
+            }
+        });
+    }
+
+    /* Make the property sets and method calls of the edges, unless they
+     * are measured */
+    if (!entry.dbusActions.empty() && !entry.measure)
+    {
+        auto& logLimit = ratelimit::get(entry.lineMsg, entry.logLimits);
+        gpio->addEdgeCallback([&entry, &logLimit](bool value,
+                                                  const timespec&) {
+            auto itr = entry.dbusActions.find(value ? "RISING" : "FALLING");
+            if (itr == entry.dbusActions.end())
+            {
+                return;
+            }
+            for (const auto& action : itr->second)
+            {
+                action.run(*entry.conn, logLimit);
+            }
+        });
+    }
+
+    /* Run the programs of the edges, unless they are measured */
+    if (!entry.execActions.empty() && !entry.measure)
+    {
+        gpio->addEdgeCallback([&entry](bool value, const timespec&) {
+            auto itr = entry.execActions.find(value ? "RISING" : "FALLING");
+            if (itr == entry.execActions.end())
+            {
+                return;
+            }
+            for (const auto& action : itr->second)
+            {
+                action->run();
+            }
+        });
+    }
+
+    /* Measure the edges instead of handling each of them */
+    if (entry.measure)
+    {
+        gpio->setRecordEdges(false);
+        gpio->addEdgeCallback(
+            [measure = entry.measure.get()](bool value, const timespec& ts) {
+                measure->edge(value, ts);
+            });
+    }
+}
+
 }
 } // namespace phosphor
 
@@ -33,11 +564,78 @@ int main(int argc, char** argv)
     CLI::App app{"Monitor GPIO line for requested state change"};
 
     std::string gpioFileName;
+    std::string journalFile = std::string(phosphor::gpio::journal::journalDir) +
+                              "/multi-gpio-monitor.journal";
+    std::string stateFile = phosphor::gpio::linestate::defaultPath;
+    bool realtimeMode = false;
+    phosphor::gpio::realtime::Config realtimeConfig;
+    phosphor::gpio::ratelimit::Config logConfig;
+    phosphor::gpio::looplag::Config lagConfig;
+    size_t timelineSize = phosphor::gpio::timeline::defaultCapacity;
+    std::string timelineDir = phosphor::gpio::journal::journalDir;
+    unsigned lineIntervalMs = 100;
+    unsigned slowActionMs = 1000;
+    phosphor::gpio::ActionQueue::Config queueConfig;
+    phosphor::gpio::LinePoller::Config pollConfig;
+    unsigned pollMinMs = pollConfig.minInterval.count();
+    unsigned pollMaxMs = pollConfig.maxInterval.count();
+    phosphor::gpio::StormDetector::Config stormConfig;
+    unsigned stormPollMs = stormConfig.pollInterval.count();
+    unsigned stormQuietMs = stormConfig.quietTime.count();
 
     /* Add an input option */
     app.add_option("-c,--config", gpioFileName, "Name of config json file")
         ->required()
         ->check(CLI::ExistingFile);
+    app.add_option(
+        "--journal", journalFile,
+        "Binary event journal, empty to log every edge to the system journal");
+    app.add_option("--state-table", stateFile,
+                   "Shared memory table of the line states, empty disables it");
+    app.add_option("--log-rate", logConfig.defaults.rate,
+                   "Log messages per second allowed per line and message")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--log-burst", logConfig.defaults.burst,
+                   "Log messages allowed in a burst per line and message")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--log-summary-interval", logConfig.summaryInterval,
+                   "Seconds between suppressed log message summaries")
+        ->check(CLI::PositiveNumber);
+    app.add_flag("--realtime", realtimeMode,
+                 "Lock memory and service GPIO events with SCHED_FIFO");
+    app.add_option("--rt-priority", realtimeConfig.priority,
+                   "SCHED_FIFO priority used with --realtime")
+        ->check(CLI::Range(1, 99));
+    app.add_option("--rt-cpu", realtimeConfig.cpu,
+                   "CPU to pin the event loop to with --realtime")
+        ->check(CLI::Range(-1, phosphor::gpio::realtime::maxCpu));
+    phosphor::gpio::looplag::addOptions(app, lagConfig);
+    app.add_option("--timeline-size", timelineSize,
+                   "Edges kept in the timeline of all lines, 0 disables it");
+    app.add_option("--timeline-dir", timelineDir,
+                   "Directory of the timeline trace files");
+    app.add_option("--line-interval-ms", lineIntervalMs,
+                   "Minimum time between two change signals of a line");
+    app.add_option("--slow-action-ms", slowActionMs,
+                   "Edge to unit start job completion time logged as slow")
+        ->check(CLI::PositiveNumber);
+    phosphor::gpio::ActionQueue::addOptions(app, queueConfig);
+    app.add_option("--poll-min-ms", pollMinMs,
+                   "Poll interval of lines without edge events after a change")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--poll-max-ms", pollMaxMs,
+                   "Poll interval of idle lines without edge events")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--storm-rate", stormConfig.rate,
+                   "Edges per second switching a line to polling, 0 disables "
+                   "storm detection");
+    app.add_option("--storm-poll-ms", stormPollMs,
+                   "Poll interval of storming lines")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--storm-quiet-ms", stormQuietMs,
+                   "Time without change switching a storming line back to "
+                   "edge events")
+        ->check(CLI::PositiveNumber);
 
     /* Parse input parameter */
     try
@@ -49,6 +647,33 @@ int main(int argc, char** argv)
         return app.exit(e);
     }
 
+    phosphor::gpio::ratelimit::configure(logConfig);
+    phosphor::gpio::looplag::configure(lagConfig);
+
+    auto lineInterval = std::chrono::milliseconds(lineIntervalMs);
+    pollConfig.minInterval = std::chrono::milliseconds(pollMinMs);
+    pollConfig.maxInterval =
+        std::chrono::milliseconds(std::max(pollMinMs, pollMaxMs));
+    stormConfig.pollInterval = std::chrono::milliseconds(stormPollMs);
+    stormConfig.quietTime = std::chrono::milliseconds(stormQuietMs);
+
+    if (realtimeMode && phosphor::gpio::realtime::enable(realtimeConfig) < 0)
+    {
+        return -1;
+    }
+
+    if (!journalFile.empty())
+    {
+        phosphor::gpio::journal::open(journalFile, CLOCK_MONOTONIC);
+    }
+
+    if (!stateFile.empty())
+    {
+        phosphor::gpio::linestate::open(stateFile, CLOCK_MONOTONIC);
+    }
+
+    phosphor::gpio::startup::Phase configPhase("config");
+
     /* Get list of gpio config details from json file */
     std::ifstream file(gpioFileName);
     if (!file)
@@ -62,28 +687,73 @@ int main(int argc, char** argv)
     file >> gpioMonObj;
     file.close();
 
-    std::vector<std::unique_ptr<phosphor::gpio::GpioMonitor>> gpios;
+    if (timelineSize > 0)
+    {
+        phosphor::gpio::timeline::open(timelineSize);
+    }
+    phosphor::gpio::TimelineDump timelineDump(io, timelineDir);
+
+    phosphor::gpio::ConditionEngine conditions(io);
+    phosphor::gpio::LinePoller poller(io, pollConfig);
+
+    std::vector<phosphor::gpio::LineEntry> entries;
+    phosphor::gpio::Outputs outputs;
+
+    /* Every line is published on D-Bus */
+    auto conn = std::make_shared<sdbusplus::asio::connection>(io);
+    sdbusplus::asio::object_server server(conn);
+
+    /* Targets started by edges wait here while systemd is busy */
+    phosphor::gpio::ActionQueue actionQueue(io, queueConfig);
+    auto actionQueueIface =
+        actionQueue.publish(server, phosphor::gpio::snapshotPath);
+
+    /* Records when the units started by the lines finish starting */
+    phosphor::gpio::watchJobs(*conn, std::chrono::milliseconds(slowActionMs));
 
     for (auto& obj : gpioMonObj)
     {
-        /* GPIO Line message */
-        std::string lineMsg = "GPIO Line ";
+        /* Start policy of a unit started by the lines */
+        if (obj.find("Unit") != obj.end())
+        {
+            auto unit = obj["Unit"].get<std::string>();
+            for (const auto* key :
+                 {"LineName", "GpioNum", "ChipId", "Condition"})
+            {
+                if (obj.find(key) != obj.end())
+                {
+                    lg2::error("{UNIT}: a Unit entry cannot have a {KEY}",
+                               "UNIT", unit, "KEY", key);
+                    return -1;
+                }
+            }
 
-        /* GPIO line */
-        gpiod_line* line = nullptr;
+            auto policy = phosphor::gpio::parseStartPolicy(
+                obj.value("StartPolicy", "Always"));
+            if (!policy)
+            {
+                lg2::error("{UNIT}: unknown start policy", "UNIT", unit);
+                return -1;
+            }
 
-        /* GPIO line configuration, default to monitor both edge */
-        struct gpiod_line_request_config config{
-            "gpio_monitor", GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES, 0};
+            phosphor::gpio::trackUnit(*conn, unit, *policy);
+            continue;
+        }
+
+        /* Conditions refer to lines, they are added after all of them */
+        if (obj.find("Condition") != obj.end())
+        {
+            continue;
+        }
 
-        /* flag to monitor */
-        bool flag = false;
+        phosphor::gpio::LineEntry entry;
 
-        /* target to start */
-        std::string target;
+        /* GPIO Line message */
+        entry.lineMsg = "GPIO Line ";
+        const auto& lineMsg = entry.lineMsg;
 
-        /* multi targets to start */
-        std::map<std::string, std::vector<std::string>> targets;
+        /* GPIO line configuration, default to monitor both edge */
+        auto& config = entry.config;
 
         if (obj.find("LineName") == obj.end())
         {
@@ -99,26 +769,17 @@ int main(int argc, char** argv)
                 return -1;
             }
 
-            std::string chipIdStr = obj["ChipId"];
-            int gpioNum = obj["GpioNum"];
+            entry.chipId = obj["ChipId"];
+            entry.gpioNum = obj["GpioNum"];
 
-            lineMsg += std::to_string(gpioNum);
-
-            /* Get the GPIO line */
-            line = gpiod_line_get(chipIdStr.c_str(), gpioNum);
+            /* The offset alone names a line of every chip */
+            entry.lineMsg +=
+                entry.chipId + " " + std::to_string(entry.gpioNum);
         }
         else
         {
-            /* Find the GPIO line */
-            std::string lineName = obj["LineName"];
-            lineMsg += lineName;
-            line = gpiod_line_find(lineName.c_str());
-        }
-
-        if (line == nullptr)
-        {
-            lg2::error("Failed to find the {GPIO}", "GPIO", lineMsg);
-            continue;
+            entry.lineName = obj["LineName"];
+            entry.lineMsg += entry.lineName;
         }
 
         /* Get event to be monitored, if it is not defined then
@@ -141,8 +802,12 @@ int main(int argc, char** argv)
         /* Get flag if monitoring needs to continue after first event */
         if (obj.find("Continue") != obj.end())
         {
-            flag = obj["Continue"];
+            entry.continueRun = obj["Continue"];
         }
+        bool flag = entry.continueRun;
+
+        /* Poll the line even if it could deliver edge events */
+        entry.poll = obj.value("Poll", false);
 
         /* Parse out target argument. It is fine if the user does not
          * pass this if they are not interested in calling into any target
@@ -150,19 +815,301 @@ int main(int argc, char** argv)
          */
         if (obj.find("Target") != obj.end())
         {
-            target = obj["Target"];
+            entry.target = obj["Target"];
         }
 
         /* Parse out the targets argument if multi-targets are needed.*/
         if (obj.find("Targets") != obj.end())
         {
-            obj.at("Targets").get_to(targets);
+            obj.at("Targets").get_to(entry.targets);
+        }
+
+        try
+        {
+            entry.logLimits = phosphor::gpio::ratelimit::parse(obj);
+        }
+        catch (const std::invalid_argument& e)
+        {
+            lg2::error("{GPIO}: invalid LogRateLimit: {ERROR}", "GPIO", lineMsg,
+                       "ERROR", e);
+            return -1;
+        }
+        entry.actionQueue = &actionQueue;
+        entry.stormConfig = stormConfig;
+
+        /* Conditions refer to the line by its name */
+        if (obj.find("Name") != obj.end())
+        {
+            entry.conditionIndex =
+                conditions.addLine(obj["Name"].get<std::string>());
         }
 
-        /* Create a monitor object and let it do all the rest */
-        gpios.push_back(std::make_unique<phosphor::gpio::GpioMonitor>(
-            line, config, io, target, targets, lineMsg, flag));
+        if (obj.find("Timeline") != obj.end())
+        {
+            const auto& timelineObj = obj["Timeline"];
+            auto findEdge = phosphor::gpio::polarityMap.find(
+                timelineObj.value("Trigger", "BOTH"));
+            if (findEdge == phosphor::gpio::polarityMap.end())
+            {
+                lg2::error("{GPIO}: unknown timeline trigger", "GPIO",
+                           lineMsg);
+                return -1;
+            }
+
+            entry.timelineTrigger = findEdge->second;
+            entry.timelinePost =
+                std::chrono::milliseconds(timelineObj.value("PostMs", 1000));
+            entry.timelineDump = &timelineDump;
+        }
+
+        if (obj.find("Gestures") != obj.end())
+        {
+            if (config.request_type != GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES ||
+                !flag)
+            {
+                lg2::error("{GPIO}: gestures need both edges and Continue",
+                           "GPIO", lineMsg);
+                return -1;
+            }
+
+            entry.gestures = phosphor::gpio::makeGestures(
+                io, obj["Gestures"], lineMsg, entry.logLimits);
+        }
+
+        if (obj.find("Measure") != obj.end())
+        {
+            if (config.request_type != GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES ||
+                !flag || obj.find("Name") == obj.end())
+            {
+                lg2::error(
+                    "{GPIO}: measure needs both edges, Continue and Name",
+                    "GPIO", lineMsg);
+                return -1;
+            }
+
+            entry.measure = phosphor::gpio::makeMeasure(
+                io, server, obj["Measure"], obj["Name"].get<std::string>(),
+                lineMsg, entry.logLimits);
+            if (!entry.measure)
+            {
+                return -1;
+            }
+        }
+
+        /* Property sets and method calls replacing units running busctl */
+        if (obj.find("DBusActions") != obj.end())
+        {
+            try
+            {
+                for (const auto& [edge, actions] : obj["DBusActions"].items())
+                {
+                    if (edge != "RISING" && edge != "FALLING")
+                    {
+                        throw std::invalid_argument("unknown edge " + edge);
+                    }
+                    if (!actions.is_array())
+                    {
+                        throw std::invalid_argument(edge + " is not an array");
+                    }
+                    for (const auto& action : actions)
+                    {
+                        entry.dbusActions[edge].emplace_back(action);
+                    }
+                }
+            }
+            catch (const std::invalid_argument& e)
+            {
+                lg2::error("{GPIO}: invalid D-Bus action: {ERROR}", "GPIO",
+                           lineMsg, "ERROR", e);
+                return -1;
+            }
+            entry.conn = conn.get();
+        }
+
+        if (obj.find("Outputs") != obj.end())
+        {
+            auto actions = phosphor::gpio::makeOutputActions(
+                io, outputs, obj["Outputs"], lineMsg);
+            if (!actions)
+            {
+                return -1;
+            }
+            entry.outputs = std::move(*actions);
+        }
+
+        /* Lines without a name are published by their chip and offset */
+        entry.objectName = obj.value("Name", entry.lineName);
+        if (entry.objectName.empty())
+        {
+            entry.objectName =
+                entry.chipId + "_" + std::to_string(entry.gpioNum);
+        }
+
+        /* A second object at the same path would fail to be published */
+        if (std::any_of(entries.begin(), entries.end(), [&entry](auto& e) {
+                return e.objectName == entry.objectName;
+            }))
+        {
+            lg2::error("{GPIO}: line object {NAME} is already used", "GPIO",
+                       lineMsg, "NAME", entry.objectName);
+            return -1;
+        }
+
+        /* Programs replacing units, told the line and edge running them */
+        if (obj.find("Exec") != obj.end())
+        {
+            try
+            {
+                for (const auto& [edge, actions] : obj["Exec"].items())
+                {
+                    if (edge != "RISING" && edge != "FALLING")
+                    {
+                        throw std::invalid_argument("unknown edge " + edge);
+                    }
+                    if (!actions.is_array())
+                    {
+                        throw std::invalid_argument(edge + " is not an array");
+                    }
+                    std::map<std::string, std::string> env{
+                        {"GPIO_LINE", entry.objectName}, {"GPIO_EDGE", edge}};
+                    for (const auto& action : actions)
+                    {
+                        entry.execActions[edge].push_back(
+                            std::make_unique<phosphor::gpio::ExecAction>(
+                                io, action, env,
+                                phosphor::gpio::ratelimit::get(
+                                    lineMsg, entry.logLimits)));
+                    }
+                }
+            }
+            catch (const std::invalid_argument& e)
+            {
+                lg2::error("{GPIO}: invalid Exec action: {ERROR}", "GPIO",
+                           lineMsg, "ERROR", e);
+                return -1;
+            }
+        }
+
+        entry.object = std::make_unique<phosphor::gpio::LineObject>(
+            io, conn, server, entry.objectName, lineInterval,
+            phosphor::gpio::ratelimit::get(lineMsg, entry.logLimits));
+
+        entries.push_back(std::move(entry));
     }
+
+    configPhase.end();
+
+    phosphor::gpio::LineInfoWatcher lineWatcher(io, "gpio_monitor");
+
+    /* The line objects and conditions follow the value of a line each time
+     * it is requested */
+    auto acquirePending = [&]() {
+        phosphor::gpio::acquirePending(
+            entries, poller, lineWatcher,
+            [&io, &conditions](phosphor::gpio::LineEntry& entry) {
+                phosphor::gpio::startMonitor(entry, io, conditions);
+            },
+            [&conditions](phosphor::gpio::LineEntry& entry) {
+                entry.object->setValue(entry.gpio->value());
+                if (entry.conditionIndex)
+                {
+                    conditions.setLine(*entry.conditionIndex,
+                                       entry.gpio->value() > 0);
+                }
+            });
+    };
+
+    /* Watch before the first lookup so no chip is missed in between */
+    phosphor::gpio::ChipWatcher chipWatcher(
+        io, [&](const std::string& chip, bool added) {
+            if (added)
+            {
+                acquirePending();
+            }
+            else
+            {
+                phosphor::gpio::releaseChip(
+                    entries, chip, io, poller, lineWatcher,
+                    [](phosphor::gpio::LineEntry& entry) {
+                        entry.object->setValue(-1);
+                    });
+            }
+        });
+
+    acquirePending();
+
+    for (const auto& entry : entries)
+    {
+        if (!entry.gpio)
+        {
+            lg2::info("Failed to find the {GPIO}, waiting for its chip",
+                      "GPIO", entry.lineMsg);
+        }
+    }
+
+    for (auto& obj : gpioMonObj)
+    {
+        if (obj.find("Condition") != obj.end() &&
+            !phosphor::gpio::addCondition(conditions, obj))
+        {
+            return -1;
+        }
+    }
+    {
+        phosphor::gpio::startup::Phase dispatch("initial dispatch");
+        conditions.start();
+    }
+
+    /* The state of all lines in one call, from the line objects */
+    auto snapshot = phosphor::gpio::addSnapshot(server, [&entries]() {
+        std::vector<phosphor::gpio::LineSnapshot> lines;
+        lines.reserve(entries.size());
+        for (const auto& entry : entries)
+        {
+            lines.emplace_back(entry.objectName,
+                               entry.object->currentValue(),
+                               entry.object->lastChange());
+        }
+        return lines;
+    });
+
+    conn->request_name(phosphor::gpio::busName);
+
+    /* Every line found is armed and its INIT_* targets were started */
+    phosphor::gpio::startup::ready();
+
+    boost::asio::steady_timer logSummaryTimer(io);
+    phosphor::gpio::ratelimit::schedule(logSummaryTimer);
+
+    /* Measure the loop lag and ping the systemd watchdog */
+    boost::asio::steady_timer loopLagTimer(io);
+    phosphor::gpio::looplag::schedule(loopLagTimer);
+
+    /* The start job latency of the units and the statistics of the other
+     * actions are dumped with the costliest lines */
+    boost::asio::signal_set profileSignals(io,
+                                           phosphor::gpio::profile::dumpSignal);
+    phosphor::gpio::profile::schedule(profileSignals, [&outputs, &entries]() {
+        phosphor::gpio::dumpActionStats();
+        for (const auto& [lineMsg, output] : outputs)
+        {
+            output->dumpStats();
+        }
+        for (const auto& entry : entries)
+        {
+            for (const auto& [edge, actions] : entry.execActions)
+            {
+                for (const auto& action : actions)
+                {
+                    action->dumpStats();
+                }
+            }
+        }
+    });
+
+    boost::asio::signal_set timelineSignals(io, SIGUSR2);
+    phosphor::gpio::scheduleTimelineDump(timelineSignals, timelineDir);
+
     io.run();
 
     return 0;
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "histogram.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace histogram
+{
+
+size_t bucket(std::chrono::nanoseconds duration, size_t buckets)
+{
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration);
+    return std::min<size_t>(
+        std::bit_width(static_cast<uint64_t>(std::max<int64_t>(ms.count(), 0))),
+        buckets - 1);
+}
+
+std::string label(size_t index, size_t buckets)
+{
+    if (index == buckets - 1)
+    {
+        return ">=" + std::to_string(1U << (index - 1)) + "ms";
+    }
+    return "<" + std::to_string(1U << index) + "ms";
+}
+
+std::string format(std::span<const uint64_t> counts)
+{
+    std::string text;
+    for (size_t i = 0; i < counts.size(); i++)
+    {
+        if (counts[i] == 0)
+        {
+            continue;
+        }
+        if (!text.empty())
+        {
+            text += ", ";
+        }
+        text += label(i, counts.size()) + ": " + std::to_string(counts[i]);
+    }
+    return text;
+}
+
+} // namespace histogram
+} // namespace gpio
+} // namespace phosphor
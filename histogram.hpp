@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace histogram
+{
+
+/** @brief Returns the bucket of a duration in a histogram whose first
+ *         bucket is below 1 ms and each next one twice as wide, the last
+ *         one holding everything above
+ *
+ *  @param[in] duration - duration to count, negative ones go to the first
+ *                        bucket
+ *  @param[in] buckets  - number of buckets of the histogram
+ */
+size_t bucket(std::chrono::nanoseconds duration, size_t buckets);
+
+/** @brief Returns the label of a bucket, "<4ms" or ">=1024ms" for the last
+ *         one
+ *
+ *  @param[in] index   - bucket
+ *  @param[in] buckets - number of buckets of the histogram
+ */
+std::string label(size_t index, size_t buckets);
+
+/** @brief Formats the buckets which are not empty for the log, for example
+ *         "<1ms: 120, <4ms: 2"
+ */
+std::string format(std::span<const uint64_t> counts);
+
+} // namespace histogram
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,171 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "event_journal.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <CLI/CLI.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace phosphor::gpio::journal;
+
+/**
+ * Loads a field of the mapped journal, ordered before any later read
+ *
+ * The mapping is read-only, so atomic read-modify-write sequences some
+ * 32-bit targets use for 64-bit loads are not an option. A torn value only
+ * makes the sequence check below fail.
+ *
+ * @param[in] field - field in the mapped journal
+ *
+ * @return The current value of the field
+ */
+template <typename T>
+static T loadAcquire(const T& field)
+{
+    T value = *static_cast<const volatile T*>(&field);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return value;
+}
+
+/**
+ * Copies a record out of the ring if it still holds the wanted sequence
+ *
+ * @param[in] slot     - record in the mapped ring
+ * @param[in] sequence - sequence number expected in the slot
+ * @param[out] rec     - copy of the record
+ *
+ * @return bool - false if the writer overwrote the slot meanwhile
+ */
+static bool readRecord(const Record& slot, uint64_t sequence, Record& rec)
+{
+    if (loadAcquire(slot.sequence) != sequence)
+    {
+        return false;
+    }
+
+    std::memcpy(&rec, &slot, sizeof(rec));
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    return loadAcquire(slot.sequence) == sequence;
+}
+
+int main(int argc, char** argv)
+{
+    CLI::App app{"Decode a GPIO event journal"};
+
+    std::string path;
+    uint64_t count = 0;
+
+    app.add_option("-f,--file", path, "Journal file to decode")
+        ->required()
+        ->check(CLI::ExistingFile);
+    app.add_option("-n,--lines", count,
+                   "Only print the last N records, 0 prints all of them");
+
+    try
+    {
+        app.parse(argc, argv);
+    }
+    catch (const CLI::Error& e)
+    {
+        return app.exit(e);
+    }
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        std::cerr << "Failed to open " << path << ": " << strerror(errno)
+                  << "\n";
+        return -1;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) < 0 ||
+        static_cast<size_t>(st.st_size) < sizeof(Header))
+    {
+        std::cerr << path << " is not a GPIO event journal\n";
+        close(fd);
+        return -1;
+    }
+
+    auto size = static_cast<size_t>(st.st_size);
+    void* map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        std::cerr << "Failed to map " << path << ": " << strerror(errno)
+                  << "\n";
+        return -1;
+    }
+
+    auto header = static_cast<const Header*>(map);
+    auto records = reinterpret_cast<const Record*>(header + 1);
+
+    if (loadAcquire(header->magic) != magic ||
+        header->version != version || header->recordSize != sizeof(Record) ||
+        size < sizeof(Header) + sizeof(Record) * header->capacity)
+    {
+        std::cerr << path << " is not a supported GPIO event journal\n";
+        munmap(map, size);
+        return -1;
+    }
+
+    auto head = loadAcquire(header->head);
+    auto lineCount = loadAcquire(header->lineCount);
+
+    uint64_t first = head > header->capacity ? head - header->capacity + 1 : 1;
+    if (count != 0 && head >= count && head - count + 1 > first)
+    {
+        first = head - count + 1;
+    }
+
+    std::cout << "clock: "
+              << (header->clockId == CLOCK_REALTIME ? "realtime" : "monotonic")
+              << ", records: " << head << "\n";
+
+    uint64_t overwritten = 0;
+    for (auto sequence = first; sequence <= head; sequence++)
+    {
+        Record rec{};
+        if (!readRecord(records[(sequence - 1) % header->capacity], sequence,
+                        rec))
+        {
+            overwritten++;
+            continue;
+        }
+
+        std::string line = "line " + std::to_string(rec.lineId);
+        if (rec.lineId < lineCount && rec.lineId < maxLines)
+        {
+            const auto& name = header->lineNames[rec.lineId];
+            line.assign(name, strnlen(name, lineNameSize));
+        }
+
+        std::cout << std::setw(10) << sequence << " " << std::setw(10)
+                  << rec.timestampNs / 1000000000ULL << "." << std::setw(9)
+                  << std::setfill('0') << rec.timestampNs % 1000000000ULL
+                  << std::setfill(' ') << " "
+                  << (rec.edge == Edge::rising ? "rising " : "falling") << " "
+                  << line << " actions: " << static_cast<int>(rec.actions)
+                  << " result: " << rec.result << "\n";
+    }
+
+    if (overwritten != 0)
+    {
+        std::cout << overwritten << " records overwritten while reading\n";
+    }
+
+    munmap(map, size);
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "line_object.hpp"
+
+#include <systemd/sd-bus.h>
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/message.hpp>
+#include <sdbusplus/vtable.hpp>
+
+#include <cstring>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+LineObject::LineObject(
+    boost::asio::io_context& io,
+    const std::shared_ptr<sdbusplus::asio::connection>& conn,
+    sdbusplus::asio::object_server& server, const std::string& name,
+    std::chrono::milliseconds minInterval, ratelimit::Limiter& logLimit) :
+    conn(conn), path((sdbusplus::object_path(linePath) / name).str),
+    minInterval(minInterval), logLimit(logLimit), timer(io)
+{
+    /* The getters return the current state, the signals are throttled */
+    constexpr auto flags = sdbusplus::vtable::property_::emits_change;
+
+    iface = server.add_interface(path, lineInterface);
+    iface->register_property_r("Value", int32_t(-1), flags,
+                               [this](const auto&) { return value; });
+    iface->register_property_r("LastEdge", std::string(), flags,
+                               [this](const auto&) { return lastEdge; });
+    iface->register_property_r("EdgeCount", uint64_t(0), flags,
+                               [this](const auto&) { return edgeCount; });
+    iface->register_property_r("LastTimestamp", uint64_t(0), flags,
+                               [this](const auto&) { return lastTimestamp; });
+    iface->initialize();
+}
+
+void LineObject::setValue(int newValue)
+{
+    if (newValue == value)
+    {
+        return;
+    }
+
+    value = newValue;
+    schedulePublish();
+}
+
+void LineObject::edge(bool newValue, const timespec& ts)
+{
+    value = newValue;
+    lastEdge = newValue ? "RISING" : "FALLING";
+    edgeCount++;
+    lastTimestamp = static_cast<uint64_t>(ts.tv_sec) * 1000000 +
+                    static_cast<uint64_t>(ts.tv_nsec) / 1000;
+    schedulePublish();
+}
+
+void LineObject::schedulePublish()
+{
+    if (pending)
+    {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastPublish >= minInterval)
+    {
+        lastPublish = now;
+        publish();
+        return;
+    }
+
+    pending = true;
+    timer.expires_at(lastPublish + minInterval);
+    timer.async_wait([this](const boost::system::error_code& ec) {
+        pending = false;
+        if (ec)
+        {
+            return;
+        }
+        lastPublish = std::chrono::steady_clock::now();
+        publish();
+    });
+}
+
+void LineObject::publish()
+{
+    int rc = sd_bus_emit_properties_changed(
+        conn->get(), path.c_str(), lineInterface, "Value", "LastEdge",
+        "EdgeCount", "LastTimestamp", nullptr);
+    if (rc < 0)
+    {
+        ratelimit::error(logLimit, "Failed to signal {PATH} change: {ERROR}",
+                         "PATH", path, "ERROR", strerror(-rc));
+    }
+}
+
+} // namespace gpio
+} // namespace phosphor
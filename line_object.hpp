@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include "ratelimit.hpp"
+
+#include <time.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <sdbusplus/asio/connection.hpp>
+#include <sdbusplus/asio/object_server.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @brief Object path prefix of the monitored lines */
+constexpr auto linePath = "/xyz/openbmc_project/gpio/line";
+
+/** @brief Interface holding the state of a line */
+constexpr auto lineInterface = "xyz.openbmc_project.GPIO.Line";
+
+/** @class LineObject
+ *  @brief Publishes the state of a monitored line on D-Bus.
+ *
+ *  Properties are read from the current state, but PropertiesChanged is
+ *  emitted at most once per minimum interval, with all properties in one
+ *  signal. Edges in between are coalesced, their count is in EdgeCount.
+ */
+class LineObject
+{
+  public:
+    LineObject() = delete;
+    ~LineObject() = default;
+    LineObject(const LineObject&) = delete;
+    LineObject& operator=(const LineObject&) = delete;
+    LineObject(LineObject&&) = delete;
+    LineObject& operator=(LineObject&&) = delete;
+
+    /** @brief Constructs LineObject object.
+     *
+     *  @param[in] io          - io service running the publish timer
+     *  @param[in] conn        - connection emitting the signals
+     *  @param[in] server      - object server hosting the line
+     *  @param[in] name        - name of the line, last element of the path
+     *  @param[in] minInterval - minimum time between two signals
+     *  @param[in] logLimit    - rate limiter of the log messages of the line
+     */
+    LineObject(boost::asio::io_context& io,
+               const std::shared_ptr<sdbusplus::asio::connection>& conn,
+               sdbusplus::asio::object_server& server, const std::string& name,
+               std::chrono::milliseconds minInterval,
+               ratelimit::Limiter& logLimit);
+
+    /** @brief Sets the line value without counting an edge
+     *
+     *  @param[in] value - line value, -1 when it became unknown
+     */
+    void setValue(int value);
+
+    /** @brief Records an edge of the line
+     *
+     *  @param[in] value - new line value
+     *  @param[in] ts    - kernel timestamp of the edge, CLOCK_MONOTONIC
+     */
+    void edge(bool value, const timespec& ts);
+
+    /** @brief Returns the line value, -1 while it is unknown */
+    int32_t currentValue() const
+    {
+        return value;
+    }
+
+    /** @brief Returns the CLOCK_MONOTONIC time of the last edge in
+     *         microseconds, 0 before the first one
+     */
+    uint64_t lastChange() const
+    {
+        return lastTimestamp;
+    }
+
+  private:
+    /** @brief Emits the change now or when the interval is over */
+    void schedulePublish();
+
+    /** @brief Emits PropertiesChanged with the current state */
+    void publish();
+
+    std::shared_ptr<sdbusplus::asio::connection> conn;
+    const std::string path;
+    const std::chrono::milliseconds minInterval;
+    ratelimit::Limiter& logLimit;
+
+    /** @brief Line value, -1 while it is unknown */
+    int32_t value = -1;
+
+    /** @brief "RISING" or "FALLING", empty before the first edge */
+    std::string lastEdge;
+
+    uint64_t edgeCount = 0;
+
+    /** @brief CLOCK_MONOTONIC time of the last edge in microseconds */
+    uint64_t lastTimestamp = 0;
+
+    /** @brief Whether the timer is armed to publish a change */
+    bool pending = false;
+    std::chrono::steady_clock::time_point lastPublish;
+
+    boost::asio::steady_timer timer;
+    std::shared_ptr<sdbusplus::asio::dbus_interface> iface;
+};
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "line_profile.hpp"
+
+#include <signal.h>
+#include <time.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <vector>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace profile
+{
+
+namespace
+{
+
+std::vector<Stats> lines;
+
+/** @brief Handler running, nullptr if none */
+Handler* current = nullptr;
+
+uint64_t nowNs()
+{
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL +
+           static_cast<uint64_t>(ts.tv_nsec);
+}
+
+int signalHandler(sd_event_source*, const signalfd_siginfo*, void*)
+{
+    dump();
+    return 0;
+}
+
+} // namespace
+
+uint32_t addLine(const std::string& name)
+{
+    auto it = std::find_if(lines.begin(), lines.end(),
+                           [&name](auto& line) { return line.name == name; });
+    if (it != lines.end())
+    {
+        return it - lines.begin();
+    }
+
+    lines.push_back({.name = name});
+    return lines.size() - 1;
+}
+
+const Stats& stats(uint32_t lineId)
+{
+    return lines.at(lineId);
+}
+
+std::string top(size_t count)
+{
+    std::vector<const Stats*> sorted;
+    for (const auto& line : lines)
+    {
+        if (line.events > 0)
+        {
+            sorted.push_back(&line);
+        }
+    }
+
+    count = std::min(count, sorted.size());
+    std::partial_sort(sorted.begin(), sorted.begin() + count, sorted.end(),
+                      [](auto* a, auto* b) { return a->totalNs > b->totalNs; });
+
+    std::string text;
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto& line = *sorted[i];
+        text += line.name + ": " + std::to_string(line.events) +
+                " events, total " + std::to_string(line.totalNs / 1000) +
+                " us, max " + std::to_string(line.maxNs / 1000) +
+                " us, D-Bus " + std::to_string(line.blockedNs / 1000) +
+                " us\n";
+    }
+
+    return text;
+}
+
+void dump()
+{
+    lg2::info("Costliest GPIO lines:\n{TOP}", "TOP", top());
+}
+
+void schedule(boost::asio::signal_set& signals,
+              std::function<void()> dumpMore)
+{
+    signals.async_wait(
+        [&signals, dumpMore = std::move(dumpMore)](
+            const boost::system::error_code& ec, int) mutable {
+            if (ec)
+            {
+                return;
+            }
+            dump();
+            if (dumpMore)
+            {
+                dumpMore();
+            }
+            schedule(signals, std::move(dumpMore));
+        });
+}
+
+int attach(sd_event* event)
+{
+    /* sd_event only gets signals blocked for the process */
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, dumpSignal);
+    if (sigprocmask(SIG_BLOCK, &set, nullptr) < 0)
+    {
+        auto rc = -errno;
+        lg2::error("Failed to block the profile dump signal: {RC}", "RC", rc);
+        return rc;
+    }
+
+    auto rc = sd_event_add_signal(event, nullptr, dumpSignal, signalHandler,
+                                  nullptr);
+    if (rc < 0)
+    {
+        lg2::error("Failed to add the profile dump signal: {RC}", "RC", rc);
+    }
+
+    return rc;
+}
+
+void record(uint32_t lineId, uint64_t elapsedNs)
+{
+    auto& line = lines[lineId];
+
+    line.events++;
+    line.totalNs += elapsedNs;
+    line.maxNs = std::max(line.maxNs, elapsedNs);
+}
+
+Handler::Handler(uint32_t lineId) :
+    lineId(lineId), startNs(nowNs()), parent(current)
+{
+    current = this;
+}
+
+Handler::~Handler()
+{
+    current = parent;
+
+    /* The enclosing run of the same line already counts this time */
+    if (parent != nullptr && parent->lineId == lineId)
+    {
+        parent->nestedNs += nestedNs;
+        return;
+    }
+
+    auto elapsedNs = nowNs() - startNs;
+    if (parent != nullptr)
+    {
+        parent->nestedNs += elapsedNs;
+    }
+
+    record(lineId, elapsedNs - nestedNs);
+}
+
+Blocked::Blocked() : startNs(nowNs()) {}
+
+Blocked::~Blocked()
+{
+    if (current != nullptr)
+    {
+        lines[current->line()].blockedNs += nowNs() - startNs;
+    }
+}
+
+} // namespace profile
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <systemd/sd-event.h>
+
+#include <boost/asio/signal_set.hpp>
+
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace profile
+{
+
+/** @brief Number of lines in the dump */
+constexpr size_t topLines = 10;
+
+/** @brief Signal dumping the costliest lines to the journal */
+constexpr int dumpSignal = SIGUSR1;
+
+/** @brief Cost of the handlers of a line */
+struct Stats
+{
+    std::string name;
+    uint64_t events = 0;
+    uint64_t totalNs = 0;
+    uint64_t maxNs = 0;
+    /** @brief Part of totalNs spent waiting for D-Bus replies */
+    uint64_t blockedNs = 0;
+};
+
+/** @brief Returns the id of a line, the same for the same name so the
+ *         cost of a line adds up across re-acquisitions
+ *
+ *  @param[in] name - GPIO line message
+ */
+uint32_t addLine(const std::string& name);
+
+/** @brief Returns the cost of a line */
+const Stats& stats(uint32_t lineId);
+
+/** @brief Returns the lines with the highest total handler time, one per
+ *         text line
+ *
+ *  @param[in] count - maximum number of lines
+ */
+std::string top(size_t count = topLines);
+
+/** @brief Logs the costliest lines */
+void dump();
+
+/** @brief Dumps the costliest lines on dumpSignal in an asio loop
+ *
+ *  @param[in] signals  - set of dumpSignal, kept by the caller
+ *  @param[in] dumpMore - also called on the signal, for the statistics of
+ *                        the actions of the daemon
+ */
+void schedule(boost::asio::signal_set& signals,
+              std::function<void()> dumpMore = {});
+
+/** @brief Dumps the costliest lines on dumpSignal in an sd_event loop
+ *
+ *  @param[in] event - event loop, owns the signal source
+ *
+ *  @return 0 on success and negative errno otherwise
+ */
+int attach(sd_event* event);
+
+/** @brief Charges one handler run to a line, Handler calls it with the
+ *         time of its scope
+ *
+ *  @param[in] lineId    - id returned by addLine()
+ *  @param[in] elapsedNs - time of the run in nanoseconds
+ */
+void record(uint32_t lineId, uint64_t elapsedNs);
+
+/** @class Handler
+ *  @brief Charges the time of a scope to a line.
+ *
+ *  The time of a nested handler of another line is only charged to that
+ *  line, a nested handler of the same line is part of the enclosing run.
+ *
+ *  Times are read from CLOCK_MONOTONIC_RAW, which the vDSO serves without
+ *  a system call and which NTP slewing does not skew.
+ */
+class Handler
+{
+  public:
+    Handler() = delete;
+    Handler(const Handler&) = delete;
+    Handler& operator=(const Handler&) = delete;
+    Handler(Handler&&) = delete;
+    Handler& operator=(Handler&&) = delete;
+
+    /** @brief Starts charging a line
+     *
+     *  @param[in] lineId - id returned by addLine()
+     */
+    explicit Handler(uint32_t lineId);
+    ~Handler();
+
+    /** @brief Returns the line charged */
+    uint32_t line() const
+    {
+        return lineId;
+    }
+
+  private:
+    uint32_t lineId;
+    uint64_t startNs;
+
+    /** @brief Enclosing handler, its time excludes this one */
+    Handler* parent;
+
+    /** @brief Time of the nested handlers of other lines */
+    uint64_t nestedNs = 0;
+};
+
+/** @class Blocked
+ *  @brief Charges the time of a scope waiting for D-Bus to the line whose
+ *         handler is running, if any.
+ */
+class Blocked
+{
+  public:
+    Blocked(const Blocked&) = delete;
+    Blocked& operator=(const Blocked&) = delete;
+    Blocked(Blocked&&) = delete;
+    Blocked& operator=(Blocked&&) = delete;
+
+    Blocked();
+    ~Blocked();
+
+  private:
+    uint64_t startNs;
+};
+
+} // namespace profile
+} // namespace gpio
+} // namespace phosphor
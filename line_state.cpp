@@ -0,0 +1,232 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "line_state.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <vector>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace linestate
+{
+
+namespace
+{
+
+Header* header = nullptr;
+Slot* slots = nullptr;
+
+/** @brief Names of the lines, kept even while the table is not open */
+std::vector<std::string> names;
+
+/** @brief Writes the name of a line to its slot and counts the slot */
+void publish(uint32_t id)
+{
+    if (header == nullptr || id >= maxLines)
+    {
+        return;
+    }
+
+    auto& slot = slots[id];
+    auto len = std::min(names[id].size(), lineNameSize - 1);
+    std::memcpy(slot.name, names[id].data(), len);
+    slot.value = -1;
+    std::atomic_ref<uint32_t>(header->lineCount)
+        .store(id + 1, std::memory_order_release);
+}
+
+/** @brief Runs an update of a slot under its seqlock */
+template <typename Update>
+void write(uint32_t lineId, Update&& update)
+{
+    if (header == nullptr || lineId >= maxLines)
+    {
+        return;
+    }
+
+    auto& slot = slots[lineId];
+    std::atomic_ref<uint32_t> sequence(slot.sequence);
+    auto next = sequence.load(std::memory_order_relaxed) + 1;
+
+    sequence.store(next, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    update(slot);
+
+    sequence.store(next + 1, std::memory_order_release);
+}
+
+/** @brief Marks a table as replaced and unmaps it */
+void retire(Header* table)
+{
+    std::atomic_ref<uint32_t>(table->generation)
+        .store(0, std::memory_order_release);
+    munmap(table, tableSize);
+}
+
+/** @brief Maps the table found at a path, if it is one */
+Header* mapExisting(const std::string& path)
+{
+    int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+
+    struct stat st{};
+    void* map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= tableSize)
+    {
+        map = mmap(nullptr, tableSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                   0);
+    }
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    auto table = static_cast<Header*>(map);
+    if (table->magic != magic || table->slotSize != sizeof(Slot))
+    {
+        munmap(map, tableSize);
+        return nullptr;
+    }
+
+    return table;
+}
+
+} // namespace
+
+int open(const std::string& path, clockid_t clockId)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(
+        std::filesystem::path(path).parent_path(), ec);
+
+    /* Truncating the file readers have mapped would fault them, so the new
+     * table is built aside and renamed over the path */
+    std::string tmpPath = path + ".XXXXXX";
+    int fd = mkostemp(tmpPath.data(), O_CLOEXEC);
+    if (fd < 0)
+    {
+        auto err = errno;
+        lg2::error("Failed to create line state table {PATH}: {ERROR}",
+                   "PATH", path, "ERROR", strerror(err));
+        return -err;
+    }
+
+    if (fchmod(fd, 0644) < 0 || ftruncate(fd, tableSize) < 0)
+    {
+        auto err = errno;
+        lg2::error("Failed to size line state table {PATH}: {ERROR}", "PATH",
+                   path, "ERROR", strerror(err));
+        close(fd);
+        unlink(tmpPath.c_str());
+        return -err;
+    }
+
+    void* map =
+        mmap(nullptr, tableSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        auto err = errno;
+        lg2::error("Failed to map line state table {PATH}: {ERROR}", "PATH",
+                   path, "ERROR", strerror(err));
+        unlink(tmpPath.c_str());
+        return -err;
+    }
+
+    /* The new file starts zero filled */
+    auto table = static_cast<Header*>(map);
+    auto old = mapExisting(path);
+    uint32_t generation = old != nullptr ? old->generation + 1 : 1;
+
+    table->version = version;
+    table->slotSize = sizeof(Slot);
+    table->clockId = clockId;
+    table->generation = generation != 0 ? generation : 1;
+    table->magic = magic;
+
+    /* Readers find the known lines as soon as the table appears */
+    auto previous = header;
+    header = table;
+    slots = reinterpret_cast<Slot*>(header + 1);
+    for (uint32_t id = 0; id < names.size(); id++)
+    {
+        publish(id);
+    }
+
+    if (rename(tmpPath.c_str(), path.c_str()) < 0)
+    {
+        auto err = errno;
+        lg2::error("Failed to publish line state table {PATH}: {ERROR}",
+                   "PATH", path, "ERROR", strerror(err));
+        munmap(table, tableSize);
+        unlink(tmpPath.c_str());
+        if (old != nullptr)
+        {
+            munmap(old, tableSize);
+        }
+        header = previous;
+        slots = previous != nullptr ? reinterpret_cast<Slot*>(previous + 1)
+                                    : nullptr;
+        return -err;
+    }
+
+    /* Readers of the old table see it retired and open the new one */
+    if (old != nullptr)
+    {
+        retire(old);
+    }
+    if (previous != nullptr)
+    {
+        retire(previous);
+    }
+
+    return 0;
+}
+
+uint32_t addLine(const std::string& name)
+{
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it != names.end())
+    {
+        return it - names.begin();
+    }
+
+    uint32_t id = names.size();
+    names.push_back(name);
+    publish(id);
+
+    return id;
+}
+
+void setValue(uint32_t lineId, int32_t value)
+{
+    write(lineId, [value](Slot& slot) { slot.value = value; });
+}
+
+void edge(uint32_t lineId, bool value, const timespec& ts)
+{
+    write(lineId, [value, &ts](Slot& slot) {
+        slot.value = value;
+        slot.edges++;
+        slot.lastEdgeNs = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL +
+                          static_cast<uint64_t>(ts.tv_nsec);
+    });
+}
+
+} // namespace linestate
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,286 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace linestate
+{
+
+/** @brief "GPSL", identifies a line state table */
+constexpr uint32_t magic = 0x4750534c;
+constexpr uint32_t version = 1;
+
+/** @brief Number of slots of the table */
+constexpr size_t maxLines = 256;
+constexpr size_t lineNameSize = 40;
+
+/** @brief Table of phosphor-multi-gpio-monitor */
+constexpr auto defaultPath = "/run/phosphor-gpio-monitor/line-state";
+
+/** @struct Header
+ *  @brief Start of the table file, followed by maxLines slots.
+ */
+struct alignas(64) Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotSize;
+    /** @brief Number of slots in use, a slot is complete once counted */
+    uint32_t lineCount;
+    /** @brief Clock of the edge timestamps */
+    int32_t clockId;
+    /** @brief Counts the tables created at the path, 0 once the table was
+     *         replaced by a new one and is no longer updated */
+    uint32_t generation;
+};
+
+/** @struct Slot
+ *  @brief State of one line, alone on its cache line so that updates of
+ *  other lines do not disturb its readers.
+ *
+ *  The slot is updated under a seqlock: sequence is odd while the writer
+ *  changes the slot, a reader retries when it was odd or changed.
+ */
+struct alignas(64) Slot
+{
+    uint32_t sequence;
+    /** @brief Line value, -1 while it is unknown */
+    int32_t value;
+    /** @brief Edges seen since the daemon started */
+    uint64_t edges;
+    /** @brief Kernel timestamp of the last edge, 0 before the first one */
+    uint64_t lastEdgeNs;
+    /** @brief Line message, written before the slot is counted */
+    char name[lineNameSize];
+};
+
+static_assert(sizeof(Header) == 64);
+static_assert(sizeof(Slot) == 64);
+
+/** @brief Size of the table file */
+constexpr size_t tableSize = sizeof(Header) + sizeof(Slot) * maxLines;
+
+/** @brief Line state read from a slot */
+struct State
+{
+    int32_t value;
+    uint64_t edges;
+    uint64_t lastEdgeNs;
+};
+
+/** @brief Creates the table of this daemon, replacing an existing one.
+ *
+ *  The table is built in a new file renamed over the path, so readers of
+ *  the old one never see it shrink, they see it retired instead. Until
+ *  this succeeds, the updates do nothing.
+ *
+ *  @param[in] path    - table file
+ *  @param[in] clockId - clock of the edge timestamps
+ *
+ *  @return 0 on success and negative errno otherwise
+ */
+int open(const std::string& path, clockid_t clockId);
+
+/** @brief Returns the slot of a line, the same for the same name so a
+ *         line keeps its slot across re-acquisitions
+ *
+ *  @param[in] name - line message, truncated to fit the slot
+ */
+uint32_t addLine(const std::string& name);
+
+/** @brief Sets the value of a line without counting an edge
+ *
+ *  @param[in] lineId - id returned by addLine()
+ *  @param[in] value  - line value, -1 when it became unknown
+ */
+void setValue(uint32_t lineId, int32_t value);
+
+/** @brief Records an edge of a line
+ *
+ *  @param[in] lineId - id returned by addLine()
+ *  @param[in] value  - line value after the edge
+ *  @param[in] ts     - kernel timestamp of the edge
+ */
+void edge(uint32_t lineId, bool value, const timespec& ts);
+
+/** @class Reader
+ *  @brief Reads the table of another process without system calls once
+ *  it is mapped. Header only, so consumers need no library.
+ */
+class Reader
+{
+  public:
+    Reader() = default;
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+    Reader(Reader&&) = delete;
+    Reader& operator=(Reader&&) = delete;
+
+    ~Reader()
+    {
+        close();
+    }
+
+    /** @brief Maps a table read-only, unmapping the one mapped before
+     *
+     *  @param[in] path - table file
+     *
+     *  @return false if the file is missing or not a line state table
+     */
+    bool open(const std::string& path = defaultPath)
+    {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        /* Reading past the end of a shorter file would fault */
+        struct stat st{};
+        if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < tableSize)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        void* map = mmap(nullptr, tableSize, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED)
+        {
+            return false;
+        }
+
+        header = static_cast<const Header*>(map);
+        slots = reinterpret_cast<const Slot*>(header + 1);
+
+        if (load(header->magic) != magic || header->version != version ||
+            header->slotSize != sizeof(Slot))
+        {
+            close();
+            return false;
+        }
+
+        generation = load(header->generation);
+        return true;
+    }
+
+    /** @brief Returns whether the table mapped is no longer updated, either
+     *         never mapped or replaced by the daemon, so it has to be
+     *         opened again
+     */
+    bool stale() const
+    {
+        return header == nullptr || load(header->generation) != generation ||
+               generation == 0;
+    }
+
+    /** @brief Returns the slot of a line, if the daemon published it
+     *
+     *  @param[in] name - line message, for example "GPIO Line PS_PWROK"
+     */
+    std::optional<uint32_t> find(const std::string& name) const
+    {
+        if (header == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        auto count = load(header->lineCount);
+        for (uint32_t id = 0; id < count && id < maxLines; id++)
+        {
+            if (std::strncmp(slots[id].name, name.c_str(), lineNameSize - 1) ==
+                0)
+            {
+                return id;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /** @brief Returns a consistent copy of the state of a line
+     *
+     *  @param[in] lineId - slot returned by find()
+     *
+     *  @return nothing if the slot is not published or the table is stale
+     */
+    std::optional<State> read(uint32_t lineId) const
+    {
+        if (header == nullptr || lineId >= maxLines ||
+            lineId >= load(header->lineCount))
+        {
+            return std::nullopt;
+        }
+
+        const auto& slot = slots[lineId];
+        State state{};
+        uint32_t sequence = 0;
+
+        do
+        {
+            sequence = load(slot.sequence);
+            state.value = load(slot.value);
+            state.edges = load(slot.edges);
+            state.lastEdgeNs = load(slot.lastEdgeNs);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((sequence & 1) != 0 || load(slot.sequence) != sequence);
+
+        if (stale())
+        {
+            return std::nullopt;
+        }
+
+        return state;
+    }
+
+  private:
+    void close()
+    {
+        if (header != nullptr)
+        {
+            munmap(const_cast<Header*>(header), tableSize);
+        }
+        header = nullptr;
+        slots = nullptr;
+        generation = 0;
+    }
+
+    /** @brief Loads a field of the read-only mapping, ordered before any
+     *         later read; a torn value makes the sequence check fail
+     */
+    template <typename T>
+    static T load(const T& field)
+    {
+        T value = *static_cast<const volatile T*>(&field);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return value;
+    }
+
+    const Header* header = nullptr;
+    const Slot* slots = nullptr;
+
+    /** @brief Generation of the table when it was mapped */
+    uint32_t generation = 0;
+};
+
+} // namespace linestate
+} // namespace gpio
+} // namespace phosphor
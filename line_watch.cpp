@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "line_watch.hpp"
+
+#include "ratelimit.hpp"
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <boost/asio/buffer.hpp>
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+std::string LineInfoWatcher::describe(uint64_t flags)
+{
+    std::string text = flags & GPIO_V2_LINE_FLAG_OUTPUT ? "output" : "input";
+
+    if (flags & GPIO_V2_LINE_FLAG_ACTIVE_LOW)
+    {
+        text += " active-low";
+    }
+    if (flags & GPIO_V2_LINE_FLAG_BIAS_PULL_UP)
+    {
+        text += " pull-up";
+    }
+    else if (flags & GPIO_V2_LINE_FLAG_BIAS_PULL_DOWN)
+    {
+        text += " pull-down";
+    }
+    else if (flags & GPIO_V2_LINE_FLAG_BIAS_DISABLED)
+    {
+        text += " bias-disabled";
+    }
+    if (flags & GPIO_V2_LINE_FLAG_OPEN_DRAIN)
+    {
+        text += " open-drain";
+    }
+    else if (flags & GPIO_V2_LINE_FLAG_OPEN_SOURCE)
+    {
+        text += " open-source";
+    }
+
+    return text;
+}
+
+int LineInfoWatcher::watch(const std::string& chip, unsigned offset,
+                           const std::string& lineMsg, Released released)
+{
+    auto it = std::find_if(chips.begin(), chips.end(),
+                           [&chip](auto& c) { return c->name == chip; });
+    if (it == chips.end())
+    {
+        auto path = "/dev/" + chip;
+        int fd = open(path.c_str(), O_RDWR | O_CLOEXEC | O_NONBLOCK);
+        if (fd < 0)
+        {
+            lg2::error("Failed to open {CHIP} to watch {GPIO}: {ERROR}",
+                       "CHIP", chip, "GPIO", lineMsg, "ERROR",
+                       strerror(errno));
+            return -1;
+        }
+
+        auto watched = std::make_shared<Chip>(io, chip);
+        watched->descriptor.assign(fd);
+        it = chips.insert(chips.end(), watched);
+        scheduleRead(watched);
+    }
+    auto& watched = **it;
+
+    gpio_v2_line_info info{};
+    info.offset = offset;
+    if (ioctl(watched.descriptor.native_handle(),
+              GPIO_V2_GET_LINEINFO_WATCH_IOCTL, &info) < 0)
+    {
+        /* Kernels before 5.10 have no v2 line info watch */
+        lg2::error("Failed to watch {GPIO}: {ERROR}", "GPIO", lineMsg,
+                   "ERROR", strerror(errno));
+        return -1;
+    }
+
+    auto& line = watched.lines[offset];
+    line.lineMsg = lineMsg;
+    line.released = std::move(released);
+    line.flags = info.flags;
+
+    if (!(info.flags & GPIO_V2_LINE_FLAG_USED))
+    {
+        line.released();
+    }
+
+    return 0;
+}
+
+void LineInfoWatcher::removeChip(const std::string& chip)
+{
+    std::erase_if(chips, [&chip](auto& watched) {
+        if (watched->name != chip)
+        {
+            return false;
+        }
+        watched->descriptor.close();
+        return true;
+    });
+}
+
+void LineInfoWatcher::scheduleRead(const std::shared_ptr<Chip>& chip)
+{
+    chip->descriptor.async_read_some(
+        boost::asio::buffer(chip->events),
+        [this, weak = std::weak_ptr<Chip>(chip)](
+            const boost::system::error_code& ec, size_t size) {
+            auto chip = weak.lock();
+            if (ec == boost::asio::error::operation_aborted || !chip)
+            {
+                return;
+            }
+            if (ec)
+            {
+                /* The chip is gone, its lines are watched again when it
+                 * comes back */
+                lg2::error("{CHIP} line info watch error: {ERROR}", "CHIP",
+                           chip->name, "ERROR", ec.message());
+                return;
+            }
+
+            for (size_t i = 0; i < size / sizeof(gpio_v2_line_info_changed);
+                 i++)
+            {
+                handleChange(*chip, chip->events[i]);
+            }
+
+            scheduleRead(chip);
+        });
+}
+
+void LineInfoWatcher::handleChange(Chip& chip,
+                                   const gpio_v2_line_info_changed& event)
+{
+    auto it = chip.lines.find(event.info.offset);
+    if (it == chip.lines.end())
+    {
+        return;
+    }
+    auto& line = it->second;
+    auto& logLimit = ratelimit::get(line.lineMsg);
+
+    auto previous = line.flags;
+    line.flags = event.info.flags;
+
+    switch (event.event_type)
+    {
+        case GPIO_V2_LINE_CHANGED_REQUESTED:
+            if (consumer == event.info.consumer)
+            {
+                return;
+            }
+            line.changes++;
+            ratelimit::warning(
+                logLimit, "{GPIO} requested by {CONSUMER} as {FLAGS}", "GPIO",
+                line.lineMsg, "CONSUMER", event.info.consumer, "FLAGS",
+                describe(event.info.flags));
+            break;
+        case GPIO_V2_LINE_CHANGED_RELEASED:
+            line.released();
+            break;
+        case GPIO_V2_LINE_CHANGED_CONFIG:
+            line.changes++;
+            ratelimit::warning(
+                logLimit,
+                "{GPIO} reconfigured from {OLD} to {NEW}, {COUNT} changes",
+                "GPIO", line.lineMsg, "OLD", describe(previous), "NEW",
+                describe(event.info.flags), "COUNT", line.changes);
+            break;
+        default:
+            break;
+    }
+}
+
+} // namespace gpio
+} // namespace phosphor
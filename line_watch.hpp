@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <linux/gpio.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @class LineInfoWatcher
+ *  @brief Watches configured lines for changes made by other consumers.
+ *
+ *  libgpiod v1 has no line info watch, so this uses the
+ *  GPIO_V2_GET_LINEINFO_WATCH_IOCTL of the kernel uAPI on a descriptor of
+ *  each chip. Requests by other consumers and reconfigurations are logged
+ *  and counted, releases are reported so that a line held by another
+ *  consumer is acquired as soon as it is free.
+ */
+class LineInfoWatcher
+{
+  public:
+    /** @brief Called when a watched line is free */
+    using Released = std::function<void()>;
+
+    LineInfoWatcher() = delete;
+    ~LineInfoWatcher() = default;
+    LineInfoWatcher(const LineInfoWatcher&) = delete;
+    LineInfoWatcher& operator=(const LineInfoWatcher&) = delete;
+    LineInfoWatcher(LineInfoWatcher&&) = delete;
+    LineInfoWatcher& operator=(LineInfoWatcher&&) = delete;
+
+    /** @brief Constructs LineInfoWatcher object.
+     *
+     *  @param[in] io       - io service
+     *  @param[in] consumer - consumer name of the requests of the daemon,
+     *                        which are not reported
+     */
+    LineInfoWatcher(boost::asio::io_context& io, const std::string& consumer) :
+        io(io), consumer(consumer)
+    {}
+
+    /** @brief Starts watching a line
+     *
+     *  When the line is free already, released is called right away.
+     *
+     *  @param[in] chip     - device name of the chip, for example gpiochip3
+     *  @param[in] offset   - offset of the line on the chip
+     *  @param[in] lineMsg  - GPIO line message used for log
+     *  @param[in] released - called when the line is released
+     *
+     *  @return 0 on success, -1 if the line cannot be watched
+     */
+    int watch(const std::string& chip, unsigned offset,
+              const std::string& lineMsg, Released released);
+
+    /** @brief Stops watching the lines of a chip which was removed
+     *
+     *  @param[in] chip - device name of the chip
+     */
+    void removeChip(const std::string& chip);
+
+    /** @brief Returns a readable description of line info flags */
+    static std::string describe(uint64_t flags);
+
+  private:
+    struct Line
+    {
+        std::string lineMsg;
+        Released released;
+        /** @brief Flags of the last info, to log what changed */
+        uint64_t flags = 0;
+        /** @brief Changes made by other consumers */
+        uint64_t changes = 0;
+    };
+
+    /** @brief Watch descriptor of a chip and its watched lines */
+    struct Chip
+    {
+        Chip(boost::asio::io_context& io, const std::string& name) :
+            name(name), descriptor(io)
+        {}
+
+        std::string name;
+        boost::asio::posix::stream_descriptor descriptor;
+        std::map<unsigned, Line> lines;
+        std::array<gpio_v2_line_info_changed, 16> events{};
+    };
+
+    /** @brief Waits for the next changes of a chip */
+    void scheduleRead(const std::shared_ptr<Chip>& chip);
+
+    /** @brief Handles a change of a watched line */
+    void handleChange(Chip& chip, const gpio_v2_line_info_changed& event);
+
+    boost::asio::io_context& io;
+    const std::string consumer;
+
+    /** @brief Chips with watched lines, the reads only keep weak
+     *         references so a removed chip can be dropped at any time */
+    std::vector<std::shared_ptr<Chip>> chips;
+};
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,245 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "loop_lag.hpp"
+
+#include "histogram.hpp"
+#include "ratelimit.hpp"
+
+#include <systemd/sd-daemon.h>
+
+#include <CLI/CLI.hpp>
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace looplag
+{
+
+/* Interval between two histogram summaries */
+constexpr auto reportInterval = std::chrono::seconds(60);
+
+namespace
+{
+
+Config settings;
+
+/** @brief WatchdogSec= of the service, zero when not set */
+std::chrono::microseconds watchdog{0};
+bool initialized = false;
+Clock::time_point lastPing;
+Clock::time_point lastReport;
+
+std::array<uint64_t, buckets> lags{};
+uint64_t ticks = 0;
+Clock::duration maxLag{};
+
+/** @brief Slowest handler since the last tick, the detail is copied as the
+ *         handler object may be gone by then
+ */
+struct Slowest
+{
+    const char* handler = nullptr;
+    std::array<char, 64> detail{};
+    Clock::duration duration{};
+};
+
+Slowest slowest;
+
+uint64_t toUs(Clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+        .count();
+}
+
+void init()
+{
+    if (initialized)
+    {
+        return;
+    }
+    initialized = true;
+
+    uint64_t usec = 0;
+    if (sd_watchdog_enabled(0, &usec) > 0)
+    {
+        watchdog = std::chrono::microseconds(usec);
+        lg2::info("Pinging the systemd watchdog, timeout {TIMEOUT_US} us",
+                  "TIMEOUT_US", usec);
+    }
+
+    lastPing = lastReport = Clock::now();
+}
+
+/** @brief Returns the timer interval, short enough to ping the watchdog
+ *         several times per timeout
+ */
+Clock::duration tickInterval()
+{
+    Clock::duration interval = settings.interval;
+    if (watchdog.count() > 0)
+    {
+        interval = std::min<Clock::duration>(interval, watchdog / 4);
+    }
+    return interval;
+}
+
+int timerHandler(sd_event_source* source, uint64_t usec, void* data)
+{
+    uint64_t nowUs = 0;
+    sd_event_now(static_cast<sd_event*>(data), CLOCK_MONOTONIC, &nowUs);
+
+    Clock::time_point now{std::chrono::microseconds(nowUs)};
+    tick(Clock::time_point(std::chrono::microseconds(usec)), now);
+
+    sd_event_source_set_time(source, nowUs + toUs(tickInterval()));
+    sd_event_source_set_enabled(source, SD_EVENT_ONESHOT);
+
+    return 0;
+}
+
+} // namespace
+
+void addOptions(CLI::App& app, Config& config)
+{
+    app.add_option_function<unsigned>(
+           "--stall-threshold-ms",
+           [&config](const unsigned& ms) {
+               config.stallThreshold = std::chrono::milliseconds(ms);
+           },
+           "Event loop lag or handler run time logged as a stall")
+        ->check(CLI::PositiveNumber);
+}
+
+void configure(const Config& config)
+{
+    settings = config;
+}
+
+const Config& config()
+{
+    return settings;
+}
+
+size_t bucket(Clock::duration lag)
+{
+    return histogram::bucket(lag, buckets);
+}
+
+const std::array<uint64_t, buckets>& histogram()
+{
+    return lags;
+}
+
+void tick(Clock::time_point due, Clock::time_point now)
+{
+    auto lag = std::max(now - due, Clock::duration{});
+
+    lags[bucket(lag)]++;
+    ticks++;
+    maxLag = std::max(maxLag, lag);
+
+    if (lag >= settings.stallThreshold)
+    {
+        ratelimit::warning(
+            ratelimit::get("event loop"),
+            "Event loop stalled for {LAG_US} us, slowest handler {HANDLER} {DETAIL} took {DURATION_US} us",
+            "LAG_US", toUs(lag), "HANDLER",
+            slowest.handler ? slowest.handler : "unknown", "DETAIL",
+            slowest.detail.data(), "DURATION_US", toUs(slowest.duration));
+    }
+    slowest = Slowest{};
+
+    if (watchdog.count() > 0 && now - lastPing >= watchdog / 4)
+    {
+        sd_notify(0, "WATCHDOG=1");
+        lastPing = now;
+    }
+
+    if (now - lastReport < reportInterval)
+    {
+        return;
+    }
+
+    /* Only lag worth looking at is reported */
+    if (maxLag >= std::chrono::milliseconds(1))
+    {
+        lg2::info(
+            "Event loop lag over {COUNT} ticks: max {MAX_US} us, histogram {HISTOGRAM}",
+            "COUNT", ticks, "MAX_US", toUs(maxLag), "HISTOGRAM",
+            histogram::format(lags));
+    }
+
+    ticks = 0;
+    maxLag = {};
+    lastReport = now;
+}
+
+void schedule(boost::asio::steady_timer& timer)
+{
+    init();
+
+    auto due = Clock::now() + tickInterval();
+    timer.expires_at(due);
+    timer.async_wait([&timer, due](const boost::system::error_code& ec) {
+        if (ec)
+        {
+            return;
+        }
+        tick(due, Clock::now());
+        schedule(timer);
+    });
+}
+
+int attach(sd_event* event)
+{
+    init();
+
+    uint64_t nowUs = 0;
+    sd_event_now(event, CLOCK_MONOTONIC, &nowUs);
+
+    /* Owned by the loop, an accuracy of 1 us keeps the timer from being
+     * coalesced, which would show as lag */
+    auto rc = sd_event_add_time(event, nullptr, CLOCK_MONOTONIC,
+                                nowUs + toUs(tickInterval()), 1, timerHandler,
+                                event);
+    if (rc < 0)
+    {
+        lg2::error("Failed to add event loop lag timer: {RC}", "RC", rc);
+    }
+
+    return rc;
+}
+
+Scope::~Scope()
+{
+    auto duration = Clock::now() - start;
+    if (duration <= slowest.duration)
+    {
+        return;
+    }
+
+    slowest.handler = handler;
+    slowest.duration = duration;
+    auto size = std::min(detail.size(), slowest.detail.size() - 1);
+    std::copy_n(detail.data(), size, slowest.detail.data());
+    slowest.detail[size] = '\0';
+
+    if (duration >= settings.stallThreshold)
+    {
+        ratelimit::warning(
+            ratelimit::get("event loop"),
+            "{HANDLER} {DETAIL} blocked the event loop for {DURATION_US} us",
+            "HANDLER", handler, "DETAIL", slowest.detail.data(), "DURATION_US",
+            toUs(duration));
+    }
+}
+
+} // namespace looplag
+} // namespace gpio
+} // namespace phosphor
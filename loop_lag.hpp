@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <systemd/sd-event.h>
+
+#include <boost/asio/steady_timer.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace CLI
+{
+class App;
+}
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace looplag
+{
+
+using Clock = std::chrono::steady_clock;
+
+/** @brief Number of lag histogram buckets, the first one below 1 ms and
+ *         each next one twice as wide, up to 1 s and above
+ */
+constexpr size_t buckets = 12;
+
+/** @brief Event loop stall detection settings */
+struct Config
+{
+    /** @brief Interval of the timer measuring the loop lag */
+    std::chrono::milliseconds interval{100};
+
+    /** @brief Lag, or handler run time, logged as a stall */
+    std::chrono::milliseconds stallThreshold{500};
+};
+
+/** @brief Adds the stall detection options of the daemons
+ *
+ *  @param[in] app    - command line parser of main()
+ *  @param[in] config - settings set by the options, passed to configure()
+ *                      after parsing
+ */
+void addOptions(CLI::App& app, Config& config);
+
+/** @brief Sets the stall detection settings, called from main() */
+void configure(const Config& config);
+
+/** @brief Returns the stall detection settings */
+const Config& config();
+
+/** @brief Returns the histogram bucket of a lag */
+size_t bucket(Clock::duration lag);
+
+/** @brief Returns the lag histogram since the process started */
+const std::array<uint64_t, buckets>& histogram();
+
+/** @brief Records a run of the lag timer.
+ *
+ *  Adds the lag to the histogram, logs a stall with the slowest handler
+ *  since the previous run, pings the systemd watchdog when WatchdogSec= is
+ *  set and periodically logs the histogram.
+ *
+ *  @param[in] due - time the timer was due
+ *  @param[in] now - time the timer ran
+ */
+void tick(Clock::time_point due, Clock::time_point now);
+
+/** @brief Runs the lag timer on an asio loop
+ *
+ *  @param[in] timer - timer of the loop, kept by the caller
+ */
+void schedule(boost::asio::steady_timer& timer);
+
+/** @brief Runs the lag timer on an sd_event loop
+ *
+ *  @param[in] event - event loop, owns the timer source
+ *
+ *  @return 0 on success and negative errno otherwise
+ */
+int attach(sd_event* event);
+
+/** @class Scope
+ *  @brief Times a handler run from the event loop.
+ *
+ *  The slowest handler between two runs of the lag timer is named when
+ *  the loop stalled, a handler running longer than the stall threshold is
+ *  logged right away.
+ */
+class Scope
+{
+  public:
+    Scope() = delete;
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    Scope(Scope&&) = delete;
+    Scope& operator=(Scope&&) = delete;
+
+    /** @brief Starts timing a handler
+     *
+     *  @param[in] handler - handler name, a string literal
+     *  @param[in] detail  - what it handles, for example the line message
+     */
+    explicit Scope(const char* handler, std::string_view detail = {}) :
+        handler(handler), detail(detail), start(Clock::now())
+    {}
+
+    ~Scope();
+
+  private:
+    const char* handler;
+    std::string_view detail;
+    Clock::time_point start;
+};
+
+} // namespace looplag
+} // namespace gpio
+} // namespace phosphor
@@ -1,18 +1,28 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: Copyright 2016 IBM Corporation
 
+#include "event_journal.hpp"
+#include "line_profile.hpp"
+#include "loop_lag.hpp"
 #include "monitor.hpp"
+#include "ratelimit.hpp"
+#include "realtime.hpp"
+#include "startup.hpp"
 
 #include <systemd/sd-event.h>
 
 #include <CLI/CLI.hpp>
 #include <phosphor-logging/lg2.hpp>
 
+#include <filesystem>
 #include <iostream>
+#include <optional>
 #include <string>
 
 int main(int argc, char** argv)
 {
+    phosphor::gpio::startup::Phase configPhase("config");
+
     CLI::App app{"Monitor GPIO line for requested state change"};
 
     // Read arguments.
@@ -21,6 +31,11 @@ int main(int argc, char** argv)
     std::string polarity{};
     std::string target{};
     bool continueRun = false;
+    std::optional<std::string> journalFile;
+    bool realtimeMode = false;
+    phosphor::gpio::realtime::Config realtimeConfig;
+    phosphor::gpio::ratelimit::Config logConfig;
+    phosphor::gpio::looplag::Config lagConfig;
 
     /* Add an input option */
     app.add_option("-p,--path", path,
@@ -35,6 +50,27 @@ int main(int argc, char** argv)
         ->required();
     app.add_flag("-c,--continue", continueRun,
                  "Whether or not to continue after key pressed");
+    app.add_option("--journal", journalFile,
+                   "Binary event journal, empty to log every event to the "
+                   "system journal. Defaults to a file per device and key");
+    app.add_option("--log-rate", logConfig.defaults.rate,
+                   "Log messages per second allowed per message")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--log-burst", logConfig.defaults.burst,
+                   "Log messages allowed in a burst per message")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--log-summary-interval", logConfig.summaryInterval,
+                   "Seconds between suppressed log message summaries")
+        ->check(CLI::PositiveNumber);
+    phosphor::gpio::looplag::addOptions(app, lagConfig);
+    app.add_flag("--realtime", realtimeMode,
+                 "Lock memory and service GPIO events with SCHED_FIFO");
+    app.add_option("--rt-priority", realtimeConfig.priority,
+                   "SCHED_FIFO priority used with --realtime")
+        ->check(CLI::Range(1, 99));
+    app.add_option("--rt-cpu", realtimeConfig.cpu,
+                   "CPU to pin the event loop to with --realtime")
+        ->check(CLI::Range(-1, phosphor::gpio::realtime::maxCpu));
 
     /* Due to the way this process is loaded from systemd, we can end up with
      * an empty extra parameter. Go ahead and ignore it. */
@@ -50,6 +86,30 @@ int main(int argc, char** argv)
         return app.exit(e);
     }
 
+    phosphor::gpio::ratelimit::configure(logConfig);
+    phosphor::gpio::looplag::configure(lagConfig);
+
+    if (realtimeMode)
+    {
+        auto rc = phosphor::gpio::realtime::enable(realtimeConfig);
+        if (rc < 0)
+        {
+            return rc;
+        }
+    }
+
+    /* Instances may watch the same key of different input devices */
+    auto journalPath = journalFile.value_or(
+        std::string(phosphor::gpio::journal::journalDir) + "/gpio-monitor-" +
+        std::filesystem::path(path).filename().string() + "-" + key +
+        ".journal");
+    if (!journalPath.empty())
+    {
+        phosphor::gpio::journal::open(journalPath, CLOCK_REALTIME);
+    }
+
+    configPhase.end();
+
     sd_event* event = nullptr;
     auto r = sd_event_default(&event);
     if (r < 0)
@@ -60,9 +120,34 @@ int main(int argc, char** argv)
     phosphor::gpio::EventPtr eventP{event};
     event = nullptr;
 
+    // Log the suppressed message summaries periodically
+    r = phosphor::gpio::ratelimit::attach(eventP.get());
+    if (r < 0)
+    {
+        return r;
+    }
+
+    // Measure the loop lag and ping the systemd watchdog
+    r = phosphor::gpio::looplag::attach(eventP.get());
+    if (r < 0)
+    {
+        return r;
+    }
+
+    // Dump the costliest lines on SIGUSR1
+    r = phosphor::gpio::profile::attach(eventP.get());
+    if (r < 0)
+    {
+        return r;
+    }
+
     // Create a monitor object and let it do all the rest
+    phosphor::gpio::startup::Phase request("request");
     phosphor::gpio::Monitor monitor(path, std::stoi(key), std::stoi(polarity),
                                     target, eventP, continueRun);
+    request.end();
+
+    phosphor::gpio::startup::ready();
 
     // Wait for client requests until this application has processed
     // at least one expected GPIO state change
@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "measure.hpp"
+
+#include "units.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <stdexcept>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+LineMeasure::LineMeasure(
+    boost::asio::io_context& io, sdbusplus::asio::object_server& server,
+    const std::string& name, std::chrono::milliseconds window,
+    std::chrono::milliseconds interval, size_t capacity,
+    const Threshold& threshold,
+    const std::map<std::string, std::vector<std::string>>& targets,
+    ratelimit::Limiter& logLimit) :
+    name(name), meter(window, capacity), interval(interval),
+    threshold(threshold), targets(targets), logLimit(logLimit), timer(io)
+{
+    /* Rejects an unknown statistic before anything is published */
+    metric(Measurement());
+
+    /* Names are escaped, so any Name is a valid object path */
+    iface = server.add_interface(
+        (sdbusplus::object_path(measurePath) / name).str, measureInterface);
+    iface->register_property("Edges", uint64_t(0));
+    iface->register_property("Frequency", 0.0);
+    iface->register_property("DutyCycle", 0.0);
+    iface->register_property("MinPulseWidth", uint64_t(0));
+    iface->register_property("MaxPulseWidth", uint64_t(0));
+    iface->initialize();
+
+    schedulePublish();
+}
+
+void LineMeasure::edge(bool value, const timespec& ts)
+{
+    /* gpiod edge timestamps and std::chrono::steady_clock are both
+     * CLOCK_MONOTONIC */
+    auto time = std::chrono::duration_cast<PulseMeter::Clock::duration>(
+        std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec));
+    meter.edge(value, PulseMeter::Clock::time_point(time));
+}
+
+void LineMeasure::schedulePublish()
+{
+    timer.expires_after(interval);
+    timer.async_wait([this](const boost::system::error_code& ec) {
+        if (ec)
+        {
+            return;
+        }
+        publish();
+        schedulePublish();
+    });
+}
+
+void LineMeasure::publish()
+{
+    auto measurement = meter.measure(PulseMeter::Clock::now());
+
+    /* Only changed values emit PropertiesChanged */
+    iface->set_property("Edges", measurement.edges);
+    iface->set_property("Frequency", measurement.frequency);
+    iface->set_property("DutyCycle", measurement.dutyCycle);
+    iface->set_property("MinPulseWidth", measurement.minPulseWidth);
+    iface->set_property("MaxPulseWidth", measurement.maxPulseWidth);
+
+    if (threshold.metric.empty())
+    {
+        return;
+    }
+
+    auto value = metric(measurement);
+    auto next = Range::normal;
+    if (threshold.low && value < *threshold.low)
+    {
+        next = Range::low;
+    }
+    else if (threshold.high && value > *threshold.high)
+    {
+        next = Range::high;
+    }
+
+    if (next == range)
+    {
+        return;
+    }
+    range = next;
+
+    const char* rangeName = next == Range::low    ? "LOW"
+                            : next == Range::high ? "HIGH"
+                                                  : "NORMAL";
+    ratelimit::info(logLimit, "{NAME} {METRIC} {VALUE} is {RANGE}", "NAME",
+                    name, "METRIC", threshold.metric, "VALUE", value, "RANGE",
+                    rangeName);
+
+    if (auto itr = targets.find(rangeName); itr != targets.end())
+    {
+        startUnits(itr->second, logLimit);
+    }
+}
+
+double LineMeasure::metric(const Measurement& measurement) const
+{
+    if (threshold.metric.empty() || threshold.metric == "Frequency")
+    {
+        return measurement.frequency;
+    }
+    if (threshold.metric == "Edges")
+    {
+        return measurement.edges;
+    }
+    if (threshold.metric == "DutyCycle")
+    {
+        return measurement.dutyCycle;
+    }
+    if (threshold.metric == "MinPulseWidth")
+    {
+        return measurement.minPulseWidth;
+    }
+    if (threshold.metric == "MaxPulseWidth")
+    {
+        return measurement.maxPulseWidth;
+    }
+
+    throw std::invalid_argument("Unknown statistic " + threshold.metric);
+}
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include "pulse_meter.hpp"
+#include "ratelimit.hpp"
+
+#include <time.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <sdbusplus/asio/object_server.hpp>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @brief Object path prefix of the measured lines */
+constexpr auto measurePath = "/xyz/openbmc_project/gpio/measure";
+
+/** @brief Interface holding the measurement of a line */
+constexpr auto measureInterface = "xyz.openbmc_project.GPIO.Measurement";
+
+/** @class LineMeasure
+ *  @brief Publishes the edge statistics of a line on D-Bus.
+ *
+ *  Edges only update the pulse meter. The statistics are computed,
+ *  published and checked against the threshold by a timer, so the D-Bus
+ *  traffic does not depend on the edge rate.
+ */
+class LineMeasure
+{
+  public:
+    /** @brief Bounds of a statistic, targets start when it crosses one */
+    struct Threshold
+    {
+        /** @brief Statistic checked: Edges, Frequency, DutyCycle,
+         *         MinPulseWidth or MaxPulseWidth */
+        std::string metric;
+        std::optional<double> low;
+        std::optional<double> high;
+    };
+
+    LineMeasure() = delete;
+    ~LineMeasure() = default;
+    LineMeasure(const LineMeasure&) = delete;
+    LineMeasure& operator=(const LineMeasure&) = delete;
+    LineMeasure(LineMeasure&&) = delete;
+    LineMeasure& operator=(LineMeasure&&) = delete;
+
+    /** @brief Constructs LineMeasure object.
+     *
+     *  @param[in] io        - io service running the publish timer
+     *  @param[in] server    - object server hosting the measurement
+     *  @param[in] name      - name of the line, last element of the path
+     *  @param[in] window    - length of the sliding window
+     *  @param[in] interval  - time between two publications
+     *  @param[in] capacity  - maximum number of edges kept in the window
+     *  @param[in] threshold - bounds of a statistic
+     *  @param[in] targets   - systemd units started when the statistic goes
+     *                         below (LOW), above (HIGH) or back between
+     *                         (NORMAL) the bounds
+     *  @param[in] logLimit  - rate limiter of the log messages of the line
+     *
+     *  @throw std::invalid_argument if the threshold statistic is unknown
+     */
+    LineMeasure(boost::asio::io_context& io,
+                sdbusplus::asio::object_server& server,
+                const std::string& name, std::chrono::milliseconds window,
+                std::chrono::milliseconds interval, size_t capacity,
+                const Threshold& threshold,
+                const std::map<std::string, std::vector<std::string>>& targets,
+                ratelimit::Limiter& logLimit);
+
+    /** @brief Records an edge of the line
+     *
+     *  @param[in] value - new line value
+     *  @param[in] ts    - kernel timestamp of the edge, CLOCK_MONOTONIC
+     */
+    void edge(bool value, const timespec& ts);
+
+  private:
+    enum class Range
+    {
+        low,
+        normal,
+        high,
+    };
+
+    /** @brief Publishes the statistics periodically */
+    void schedulePublish();
+
+    /** @brief Publishes the statistics and checks the threshold */
+    void publish();
+
+    /** @brief Returns the statistic checked by the threshold */
+    double metric(const Measurement& measurement) const;
+
+    std::string name;
+    PulseMeter meter;
+    const std::chrono::milliseconds interval;
+    const Threshold threshold;
+    const std::map<std::string, std::vector<std::string>> targets;
+    ratelimit::Limiter& logLimit;
+
+    /** @brief Range of the statistic at the last publication */
+    Range range = Range::normal;
+
+    boost::asio::steady_timer timer;
+    std::shared_ptr<sdbusplus::asio::dbus_interface> iface;
+};
+
+} // namespace gpio
+} // namespace phosphor
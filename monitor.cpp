@@ -3,6 +3,10 @@
 
 #include "monitor.hpp"
 
+#include "loop_lag.hpp"
+#include "realtime.hpp"
+#include "trace.hpp"
+
 #include <fcntl.h>
 
 #include <phosphor-logging/lg2.hpp>
@@ -20,9 +24,9 @@ constexpr auto SYSTEMD_INTERFACE = "org.freedesktop.systemd1.Manager";
 // Callback handler when there is an activity on the FD
 int Monitor::processEvents(sd_event_source*, int, uint32_t, void* userData)
 {
-    lg2::info("GPIO line altered");
     auto monitor = static_cast<Monitor*>(userData);
 
+    looplag::Scope scope("GPIO key event", monitor->path);
     monitor->analyzeEvent();
     return 0;
 }
@@ -30,6 +34,8 @@ int Monitor::processEvents(sd_event_source*, int, uint32_t, void* userData)
 // Analyzes the GPIO event
 void Monitor::analyzeEvent()
 {
+    profile::Handler cost(profileId);
+
     // Data returned
     struct input_event ev{};
     int rc = 0;
@@ -48,37 +54,69 @@ void Monitor::analyzeEvent()
             return;
         };
 
-        if (rc == LIBEVDEV_READ_STATUS_SUCCESS)
+        if (rc != LIBEVDEV_READ_STATUS_SUCCESS || ev.code != key ||
+            (ev.type == EV_SYN && ev.code == SYN_REPORT))
+        {
+            continue;
+        }
+
+        // Input events are stamped with CLOCK_REALTIME by default
+        timespec ts{static_cast<time_t>(ev.input_event_sec),
+                    static_cast<long>(ev.input_event_usec) * 1000};
+        auto edge = ev.value ? journal::Edge::rising : journal::Edge::falling;
+        GPIO_TRACE(event_read, path.c_str(), ev.value, traceNs(ts));
+
+        if (ev.value != polarity)
         {
-            if (ev.type == EV_SYN && ev.code == SYN_REPORT)
+            GPIO_TRACE(event_filtered, path.c_str(), ev.value);
+            // Key changes are only logged, when the journal is unavailable
+            if (!journal::record(journalId, edge, ts, 0, 0))
             {
-                continue;
+                ratelimit::info(logLimit, "GPIO line altered");
             }
-            else if (ev.code == key && ev.value == polarity)
+            continue;
+        }
+
+        realtime::recordLatency(CLOCK_REALTIME, ts);
+
+        // If the code/value is what we are interested in, declare done.
+        // User supplied systemd unit
+        int result = 0;
+        if (!target.empty())
+        {
+            auto bus = sdbusplus::bus::new_default();
+            auto method = bus.new_method_call(SYSTEMD_SERVICE, SYSTEMD_ROOT,
+                                              SYSTEMD_INTERFACE, "StartUnit");
+            method.append(target);
+            method.append("replace");
+
+            GPIO_TRACE(action_start, target.c_str());
+            try
+            {
+                profile::Blocked blocked;
+                bus.call_noreply(method);
+            }
+            catch (const sdbusplus::exception_t& e)
             {
-                // If the code/value is what we are interested in, declare done.
-                // User supplied systemd unit
-                if (!target.empty())
-                {
-                    auto bus = sdbusplus::bus::new_default();
-                    auto method =
-                        bus.new_method_call(SYSTEMD_SERVICE, SYSTEMD_ROOT,
-                                            SYSTEMD_INTERFACE, "StartUnit");
-                    method.append(target);
-                    method.append("replace");
-
-                    bus.call_noreply(method);
-                }
-
-                if (!continueAfterKeyPress)
-                {
-                    // This marks the completion of handling the gpio assertion
-                    // and the app can exit
-                    complete = true;
-                }
-                return;
+                ratelimit::error(logLimit, "Failed to start {UNIT}: {ERROR}",
+                                 "UNIT", target, "ERROR", e);
+                result = -e.get_errno();
             }
+            GPIO_TRACE(action_end, target.c_str(), result);
+        }
+
+        if (!journal::record(journalId, edge, ts, !target.empty(), result))
+        {
+            ratelimit::info(logLimit, "GPIO line altered");
+        }
+
+        if (!continueAfterKeyPress)
+        {
+            // This marks the completion of handling the gpio assertion
+            // and the app can exit
+            complete = true;
         }
+        return;
     };
 
     return;
@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include "event_journal.hpp"
 #include "evdev.hpp"
+#include "line_profile.hpp"
+#include "ratelimit.hpp"
 
 #include <linux/input.h>
 #include <systemd/sd-event.h>
@@ -51,7 +54,10 @@ class Monitor : public Evdev
             sd_event_io_handler_t handler = Monitor::processEvents,
             bool useEvDev = true) :
         Evdev(path, key, event, handler, useEvDev), polarity(polarity),
-        target(target), continueAfterKeyPress(continueRun) {};
+        target(target), continueAfterKeyPress(continueRun),
+        journalId(journal::addLine(path + " key " + std::to_string(key))),
+        profileId(profile::addLine(path + " key " + std::to_string(key))),
+        logLimit(ratelimit::get(path + " key " + std::to_string(key))) {};
 
     /** @brief Callback handler when the FD has some activity on it
      *
@@ -85,6 +91,15 @@ class Monitor : public Evdev
     /** @brief Completion indicator */
     bool complete = false;
 
+    /** @brief Id of the key in the event journal */
+    uint32_t journalId;
+
+    /** @brief Id of the key in the handler profile */
+    uint32_t profileId;
+
+    /** @brief Rate limiter of the hot path log messages */
+    ratelimit::Limiter& logLimit;
+
     /** @brief Analyzes the GPIO event and starts configured target */
     void analyzeEvent();
 };
@@ -3,6 +3,10 @@
 
 #include "gpio_presence.hpp"
 
+#include "line_profile.hpp"
+#include "loop_lag.hpp"
+#include "startup.hpp"
+#include "trace.hpp"
 #include "xyz/openbmc_project/Common/error.hpp"
 
 #include <phosphor-logging/elog-errors.hpp>
@@ -10,6 +14,8 @@
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/bus.hpp>
 
+#include <cerrno>
+
 namespace phosphor
 {
 namespace gpio
@@ -37,6 +43,7 @@ std::string getService(const std::string& path, const std::string& interface,
     std::map<std::string, std::vector<std::string>> mapperResponse;
     try
     {
+        profile::Blocked blocked;
         auto mapperResponseMsg = bus.call(mapperCall);
         mapperResponseMsg.read(mapperResponse);
     }
@@ -72,39 +79,65 @@ GpioPresence::ObjectMap GpioPresence::getObjectMap(bool present)
 
 void GpioPresence::updateInventory(bool present)
 {
-    ObjectMap invObj = getObjectMap(present);
+    int result =
+        notifyInventory(getObjectMap(present), inventory, present, logLimit);
+    if (result < 0)
+    {
+        elog<InternalFailure>();
+    }
+}
 
-    lg2::info(
+int GpioPresence::notifyInventory(ObjectMap&& invObj,
+                                  const std::string& inventory, bool present,
+                                  ratelimit::Limiter& logLimit)
+{
+    ratelimit::info(
+        logLimit,
         "Updating inventory present property value to {PRESENT}, path: {PATH}",
         "PRESENT", present, "PATH", inventory);
 
     auto bus = sdbusplus::bus::new_default();
-    auto invService = getService(INVENTORY_PATH, INVENTORY_INTF, bus);
+    std::string invService;
+    try
+    {
+        invService = getService(INVENTORY_PATH, INVENTORY_INTF, bus);
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        return -e.get_errno();
+    }
 
     // Update inventory
     auto invMsg = bus.new_method_call(invService.c_str(), INVENTORY_PATH,
                                       INVENTORY_INTF, "Notify");
     invMsg.append(std::move(invObj));
+    GPIO_TRACE(inventory_update, inventory.c_str(), present);
     try
     {
+        profile::Blocked blocked;
         auto invMgrResponseMsg = bus.call(invMsg);
+        GPIO_TRACE(inventory_ack, inventory.c_str(), 0);
     }
     catch (const sdbusplus::exception_t& e)
     {
+        GPIO_TRACE(inventory_ack, inventory.c_str(), -e.get_errno());
         lg2::error(
             "Error in inventory manager call to update inventory: {ERROR}",
             "ERROR", e);
-        elog<InternalFailure>();
+        return -e.get_errno();
     }
+
+    return 0;
 }
 
 void GpioPresence::scheduleEventHandler()
 {
     std::string gpio = std::string(gpioLineMsg);
+    auto& limiter = logLimit;
 
     gpioEventDescriptor.async_wait(
         boost::asio::posix::stream_descriptor::wait_read,
-        [this, gpio](const boost::system::error_code& ec) {
+        [this, gpio, &limiter](const boost::system::error_code& ec) {
             if (ec == boost::asio::error::operation_aborted)
             {
                 // we were cancelled
@@ -112,8 +145,9 @@ void GpioPresence::scheduleEventHandler()
             }
             if (ec)
             {
-                lg2::error("{GPIO} event handler error: {ERROR}", "GPIO", gpio,
-                           "ERROR", ec.message());
+                ratelimit::error(limiter,
+                                 "{GPIO} event handler error: {ERROR}", "GPIO",
+                                 gpio, "ERROR", ec.message());
                 return;
             }
             gpioEventHandler();
@@ -127,29 +161,108 @@ void GpioPresence::cancelEventHandler()
 
 void GpioPresence::gpioEventHandler()
 {
+    looplag::Scope scope("GPIO presence event", gpioLineMsg);
+    profile::Handler cost(profileId);
+
     gpiod_line_event gpioLineEvent;
 
     if (gpiod_line_event_read_fd(gpioEventDescriptor.native_handle(),
                                  &gpioLineEvent) < 0)
     {
-        lg2::error("Failed to read {GPIO} from fd", "GPIO", gpioLineMsg);
+        ratelimit::error(logLimit, "Failed to read {GPIO} from fd", "GPIO",
+                         gpioLineMsg);
         return;
     }
 
-    if (gpioLineEvent.event_type == GPIOD_LINE_EVENT_RISING_EDGE)
+    /* Two edges of the same polarity mean the kernel dropped the one
+     * between them, the inventory is updated for it too */
+    bool asserted = gpioLineEvent.event_type == GPIOD_LINE_EVENT_RISING_EDGE;
+    if (gapDetector.edge(asserted, lineValue) == GapDetector::Edge::gap)
     {
-        lg2::info("{GPIO} Asserted", "GPIO", gpioLineMsg);
+        ratelimit::warning(logLimit, "{GPIO} missed an edge, {COUNT} gaps",
+                           "GPIO", gpioLineMsg, "COUNT", gapDetector.gaps());
+        handleEdge(!asserted, gpioLineEvent.ts);
     }
-    else
-    {
-        lg2::info("{GPIO} Deasserted", "GPIO", gpioLineMsg);
-    }
-    updateInventory(gpioLineEvent.event_type == GPIOD_LINE_EVENT_RISING_EDGE);
+
+    handleEdge(asserted, gpioLineEvent.ts);
 
     /* Schedule a wait event */
     scheduleEventHandler();
 }
 
+void GpioPresence::pollEvent(bool value, const timespec& ts)
+{
+    profile::Handler cost(profileId);
+
+    if (!initialized)
+    {
+        initialized = true;
+        lineValue = value;
+        startup::Phase dispatch("initial dispatch");
+        updateInventory(value);
+        return;
+    }
+
+    handleEdge(value, ts);
+}
+
+/** @brief Records an edge and the result of its inventory update.
+ *
+ *  Edges go to the binary event journal, the system journal is only used
+ *  when it could not be opened.
+ */
+static void recordEdge(uint32_t journalId, const std::string& lineMsg,
+                       ratelimit::Limiter& logLimit, bool asserted,
+                       const timespec& ts, int result)
+{
+    auto edge = asserted ? journal::Edge::rising : journal::Edge::falling;
+    if (!journal::record(journalId, edge, ts, 1, result))
+    {
+        if (asserted)
+        {
+            ratelimit::info(logLimit, "{GPIO} Asserted", "GPIO", lineMsg);
+        }
+        else
+        {
+            ratelimit::info(logLimit, "{GPIO} Deasserted", "GPIO", lineMsg);
+        }
+    }
+}
+
+void GpioPresence::handleEdge(bool asserted, const timespec& ts)
+{
+    GPIO_TRACE(event_read, gpioLineMsg.c_str(), asserted, traceNs(ts));
+    lineValue = asserted;
+    lastChangeUs = static_cast<uint64_t>(ts.tv_sec) * 1000000 +
+                   static_cast<uint64_t>(ts.tv_nsec) / 1000;
+
+    /* The edge is journaled with the result of its update, the presence
+     * object may be gone when a queued update runs */
+    auto update = [invObj = getObjectMap(asserted), path = inventory,
+                   id = journalId, lineMsg = gpioLineMsg,
+                   &limiter = logLimit, asserted, ts](bool run) mutable {
+        int result = run ? notifyInventory(std::move(invObj), path, asserted,
+                                           limiter)
+                         : -ECANCELED;
+        recordEdge(id, lineMsg, limiter, asserted, ts, result);
+        if (run && result < 0)
+        {
+            elog<InternalFailure>();
+        }
+    };
+
+    if (actionQueue == nullptr)
+    {
+        update(true);
+        return;
+    }
+
+    /* Only the latest state of the item matters, it supersedes a queued
+     * update, which is journaled as canceled */
+    actionQueue->replace(gpioLineMsg, profileId, inventory,
+                         std::move(update));
+}
+
 int GpioPresence::requestGPIOEvents()
 {
     std::string flags;
@@ -157,8 +270,26 @@ int GpioPresence::requestGPIOEvents()
     /* Request an event to monitor for respected gpio line */
     if (gpiod_line_request(gpioLine, &gpioConfig, 0) < 0)
     {
-        lg2::error("Failed to request {GPIO}: {ERRNO}", "GPIO", gpioLineMsg,
-                   "ERRNO", errno);
+        /* Lines of expanders without an interrupt cannot deliver events,
+         * the kernel reports the missing interrupt as ENODEV or ENXIO */
+        if (errno == ENODEV || errno == ENXIO || errno == EOPNOTSUPP)
+        {
+            lg2::info("Failed to request events of {GPIO}: {ERRNO}, polling it",
+                      "GPIO", gpioLineMsg, "ERRNO", errno);
+            polling = true;
+            return 0;
+        }
+
+        if (errno != EBUSY)
+        {
+            lg2::error("Failed to request events of {GPIO}: {ERRNO}", "GPIO",
+                       gpioLineMsg, "ERRNO", errno);
+            return -1;
+        }
+
+        /* Requested again when the other consumer releases it */
+        lg2::warning("{GPIO} is used by another consumer, waiting for it",
+                     "GPIO", gpioLineMsg);
         return -1;
     }
 
@@ -198,7 +329,12 @@ int GpioPresence::requestGPIOEvents()
     /* Assign line fd to descriptor for monitoring */
     gpioEventDescriptor.assign(gpioLineFd);
 
-    updateInventory(gpiod_line_get_value(gpioLine));
+    {
+        startup::Phase dispatch("initial dispatch");
+        int value = gpiod_line_get_value(gpioLine);
+        lineValue = value < 0 ? -1 : value != 0;
+        updateInventory(value);
+    }
 
     /* Schedule a wait event */
     scheduleEventHandler();
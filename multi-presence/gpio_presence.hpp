@@ -3,6 +3,12 @@
 
 #pragma once
 
+#include "action_queue.hpp"
+#include "event_journal.hpp"
+#include "gap_detector.hpp"
+#include "line_profile.hpp"
+#include "ratelimit.hpp"
+
 #include <gpiod.h>
 
 #include <boost/asio/io_context.hpp>
@@ -47,7 +53,12 @@ class GpioPresence
 
   public:
     GpioPresence() = delete;
-    ~GpioPresence() = default;
+    ~GpioPresence()
+    {
+        /* The descriptor belongs to libgpiod, which closes it with the
+         * chip */
+        gpioEventDescriptor.release();
+    }
     GpioPresence(const GpioPresence&) = delete;
     GpioPresence& operator=(const GpioPresence&) = delete;
 
@@ -62,16 +73,26 @@ class GpioPresence
                                       inventory item
      *  @param[in] name             - PrettyName of inventory object
      *  @param[in] lineMsg          - GPIO line message to be used for log
+     *  @param[in] logLimits        - rate limits of the log messages of
+                                      the line
+     *  @param[in] poll             - Whether to poll the line instead of
+                                      requesting edge events
      */
     GpioPresence(gpiod_line* line, gpiod_line_request_config& config,
                  boost::asio::io_context& io, const std::string& inventory,
                  const std::vector<std::string>& extraInterfaces,
-                 const std::string& name, const std::string& lineMsg) :
+                 const std::string& name, const std::string& lineMsg,
+                 const ratelimit::Limits& logLimits, bool poll) :
         gpioLine(line), gpioConfig(config), gpioEventDescriptor(io),
         inventory(inventory), interfaces(extraInterfaces), name(name),
-        gpioLineMsg(lineMsg)
+        gpioLineMsg(lineMsg), journalId(journal::addLine(lineMsg)),
+        profileId(profile::addLine(lineMsg)),
+        logLimit(ratelimit::get(lineMsg, logLimits)), polling(poll)
     {
-        requestGPIOEvents();
+        if (!polling)
+        {
+            requestGPIOEvents();
+        }
     };
 
     GpioPresence(GpioPresence&& old) noexcept :
@@ -79,15 +100,77 @@ class GpioPresence
         gpioEventDescriptor(old.gpioEventDescriptor.get_executor()),
         inventory(std::move(old.inventory)),
         interfaces(std::move(old.interfaces)), name(std::move(old.name)),
-        gpioLineMsg(std::move(old.gpioLineMsg))
+        gpioLineMsg(std::move(old.gpioLineMsg)), journalId(old.journalId),
+        profileId(old.profileId),
+        logLimit(old.logLimit), polling(old.polling),
+        initialized(old.initialized), lineValue(old.lineValue),
+        lastChangeUs(old.lastChangeUs), gapDetector(old.gapDetector),
+        actionQueue(old.actionQueue)
     {
         old.cancelEventHandler();
 
         gpioEventDescriptor = std::move(old.gpioEventDescriptor);
 
-        scheduleEventHandler();
+        /* Polled lines have no event descriptor */
+        if (gpioEventDescriptor.is_open())
+        {
+            scheduleEventHandler();
+        }
     };
 
+    /** @brief Returns whether the line has to be polled, either because it
+     *         was asked for or because it cannot deliver edge events
+     */
+    bool polled() const
+    {
+        return polling;
+    }
+
+    /** @brief Requests the line again after another consumer released it,
+     *         unless it is requested or polled already
+     */
+    void retryRequest()
+    {
+        if (!polling && !gpiod_line_is_requested(gpioLine))
+        {
+            requestGPIOEvents();
+        }
+    }
+
+    /** @brief Handles a value read by the poller of the line
+     *
+     *  The first value is handled as the initial presence, a change as an
+     *  edge.
+     *
+     *  @param[in] value - line value
+     *  @param[in] ts    - CLOCK_MONOTONIC time of the read
+     */
+    void pollEvent(bool value, const timespec& ts);
+
+    /** @brief Queues the inventory updates of edges instead of making them
+     *         from the event handler
+     *
+     *  @param[in] queue - action queue of the daemon
+     */
+    void setActionQueue(ActionQueue* queue)
+    {
+        actionQueue = queue;
+    }
+
+    /** @brief Returns the last known line value, -1 if it is unknown */
+    int32_t value() const
+    {
+        return lineValue;
+    }
+
+    /** @brief Returns the CLOCK_MONOTONIC time of the last edge in
+     *         microseconds, 0 before the first one
+     */
+    uint64_t lastChange() const
+    {
+        return lastChangeUs;
+    }
+
   private:
     /** @brief GPIO line */
     gpiod_line* gpioLine;
@@ -110,6 +193,33 @@ class GpioPresence
     /** @brief GPIO line name message */
     const std::string gpioLineMsg;
 
+    /** @brief Id of the line in the event journal */
+    const uint32_t journalId;
+
+    /** @brief Id of the line in the handler profile */
+    const uint32_t profileId;
+
+    /** @brief Rate limiter of the hot path log messages */
+    ratelimit::Limiter& logLimit;
+
+    /** @brief Whether the line is polled instead of delivering events */
+    bool polling;
+
+    /** @brief Whether the poller reported the initial presence */
+    bool initialized = false;
+
+    /** @brief Last known line value, -1 while it is unknown */
+    int32_t lineValue = -1;
+
+    /** @brief CLOCK_MONOTONIC time of the last edge in microseconds */
+    uint64_t lastChangeUs = 0;
+
+    /** @brief Finds the edges the kernel dropped from their neighbours */
+    GapDetector gapDetector;
+
+    /** @brief Queue of the inventory updates of edges, if any */
+    ActionQueue* actionQueue = nullptr;
+
     /** @brief register handler for gpio event
      *
      *  @return  - 0 on success and -1 otherwise
@@ -122,14 +232,31 @@ class GpioPresence
     /** @brief Stop the event handler for GPIO events */
     void cancelEventHandler();
 
-    /** @brief Handle the GPIO event and starts configured target */
+    /** @brief Reads the GPIO event and handles it */
     void gpioEventHandler();
 
+    /** @brief Updates the inventory on an edge and records it */
+    void handleEdge(bool asserted, const timespec& ts);
+
     /** @brief Returns the object map for the inventory object */
     ObjectMap getObjectMap(bool present);
 
     /** @brief Updates the inventory */
     void updateInventory(bool present);
+
+    /** @brief Sends an object map to the inventory manager
+     *
+     *  @param[in] invObj    - object map of the inventory item
+     *  @param[in] inventory - object path of the inventory item
+     *  @param[in] present   - presence of the item
+     *  @param[in] logLimit  - rate limiter of the line
+     *
+     *  @return 0 on success and negative errno otherwise, the error is
+     *          logged
+     */
+    static int notifyInventory(ObjectMap&& invObj,
+                               const std::string& inventory, bool present,
+                               ratelimit::Limiter& logLimit);
 };
 
 } // namespace gpio
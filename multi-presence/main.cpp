@@ -1,20 +1,39 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 
+#include "action_queue.hpp"
+#include "chip_watch.hpp"
+#include "config_line.hpp"
+#include "event_journal.hpp"
 #include "gpio_presence.hpp"
+#include "line_profile.hpp"
+#include "line_watch.hpp"
+#include "loop_lag.hpp"
+#include "poller.hpp"
+#include "ratelimit.hpp"
+#include "snapshot.hpp"
+#include "startup.hpp"
 
 #include <CLI/CLI.hpp>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <nlohmann/json.hpp>
 #include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/asio/connection.hpp>
+#include <sdbusplus/asio/object_server.hpp>
 
 #include <fstream>
+#include <memory>
 
 namespace phosphor
 {
 namespace gpio
 {
 
+/** @brief Bus name of the line snapshot */
+constexpr auto busName = "xyz.openbmc_project.GPIO.Presence";
+
 const std::map<std::string, int> biasMap = {
     /**< Set bias as is. */
     {"AS_IS", 0},
@@ -24,6 +43,32 @@ const std::map<std::string, int> biasMap = {
     {"PULL_UP", GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_UP},
     /**< Enable pull-down. */
     {"PULL_DOWN", GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_DOWN}};
+
+/** @brief A line entry of the config file */
+struct PresenceEntry : public ConfigLine
+{
+    std::string name;
+    std::string inventory;
+    std::vector<std::string> extraInterfaces;
+    ratelimit::Limits logLimits;
+    bool poll = false;
+
+    /** @brief Queue of the inventory updates of edges */
+    ActionQueue* actionQueue = nullptr;
+
+    /** @brief Monitor of the line, set while the line is acquired */
+    std::unique_ptr<GpioPresence> gpio;
+};
+
+/** @brief Starts monitoring the line of an entry once it is found */
+void startMonitor(PresenceEntry& entry, boost::asio::io_context& io)
+{
+    entry.gpio = std::make_unique<GpioPresence>(
+        entry.line, entry.config, io, entry.inventory, entry.extraInterfaces,
+        entry.name, entry.lineMsg, entry.logLimits, entry.poll);
+    entry.gpio->setActionQueue(entry.actionQueue);
+}
+
 }
 } // namespace phosphor
 
@@ -34,11 +79,39 @@ int main(int argc, char** argv)
     CLI::App app{"Monitor gpio presence status"};
 
     std::string gpioFileName;
+    std::string journalFile = std::string(phosphor::gpio::journal::journalDir) +
+                              "/multi-gpio-presence.journal";
+    phosphor::gpio::ratelimit::Config logConfig;
+    phosphor::gpio::looplag::Config lagConfig;
+    phosphor::gpio::ActionQueue::Config queueConfig;
+    phosphor::gpio::LinePoller::Config pollConfig;
+    unsigned pollMinMs = pollConfig.minInterval.count();
+    unsigned pollMaxMs = pollConfig.maxInterval.count();
 
     /* Add an input option */
     app.add_option("-c,--config", gpioFileName, "Name of config json file")
         ->required()
         ->check(CLI::ExistingFile);
+    app.add_option(
+        "--journal", journalFile,
+        "Binary event journal, empty to log every edge to the system journal");
+    app.add_option("--log-rate", logConfig.defaults.rate,
+                   "Log messages per second allowed per line and message")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--log-burst", logConfig.defaults.burst,
+                   "Log messages allowed in a burst per line and message")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--log-summary-interval", logConfig.summaryInterval,
+                   "Seconds between suppressed log message summaries")
+        ->check(CLI::PositiveNumber);
+    phosphor::gpio::looplag::addOptions(app, lagConfig);
+    phosphor::gpio::ActionQueue::addOptions(app, queueConfig);
+    app.add_option("--poll-min-ms", pollMinMs,
+                   "Poll interval of lines without edge events after a change")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--poll-max-ms", pollMaxMs,
+                   "Poll interval of idle lines without edge events")
+        ->check(CLI::PositiveNumber);
 
     /* Parse input parameter */
     try
@@ -50,6 +123,20 @@ int main(int argc, char** argv)
         return app.exit(e);
     }
 
+    phosphor::gpio::ratelimit::configure(logConfig);
+    phosphor::gpio::looplag::configure(lagConfig);
+
+    pollConfig.minInterval = std::chrono::milliseconds(pollMinMs);
+    pollConfig.maxInterval =
+        std::chrono::milliseconds(std::max(pollMinMs, pollMaxMs));
+
+    if (!journalFile.empty())
+    {
+        phosphor::gpio::journal::open(journalFile, CLOCK_MONOTONIC);
+    }
+
+    phosphor::gpio::startup::Phase configPhase("config");
+
     /* Get list of gpio config details from json file */
     std::ifstream file(gpioFileName);
     if (!file)
@@ -62,28 +149,27 @@ int main(int argc, char** argv)
     file >> gpioMonObj;
     file.close();
 
-    std::vector<phosphor::gpio::GpioPresence> gpios;
+    std::vector<phosphor::gpio::PresenceEntry> entries;
+    phosphor::gpio::LinePoller poller(io, pollConfig);
+
+    auto conn = std::make_shared<sdbusplus::asio::connection>(io);
+    sdbusplus::asio::object_server server(conn);
+
+    /* Inventory updates of edges wait here while the manager is busy */
+    phosphor::gpio::ActionQueue actionQueue(io, queueConfig);
+    auto actionQueueIface =
+        actionQueue.publish(server, phosphor::gpio::snapshotPath);
 
     for (auto& obj : gpioMonObj)
     {
-        /* GPIO Line message */
-        std::string lineMsg = "GPIO Line ";
+        phosphor::gpio::PresenceEntry entry;
 
-        /* GPIO line */
-        gpiod_line* line = nullptr;
+        /* GPIO Line message */
+        entry.lineMsg = "GPIO Line ";
+        const auto& lineMsg = entry.lineMsg;
 
         /* GPIO line configuration, default to monitor both edge */
-        struct gpiod_line_request_config config{
-            "gpio_monitor", GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES, 0};
-
-        /* Pretty name of the inventory object */
-        std::string name;
-
-        /* Object path under inventory that will be created */
-        std::string inventory;
-
-        /* List of interfaces to associate to inventory item */
-        std::vector<std::string> extraInterfaces;
+        auto& config = entry.config;
 
         if (obj.find("LineName") == obj.end())
         {
@@ -99,26 +185,16 @@ int main(int argc, char** argv)
                 return -1;
             }
 
-            std::string chipIdStr = obj["ChipId"].get<std::string>();
-            int gpioNum = obj["GpioNum"].get<int>();
+            entry.chipId = obj["ChipId"].get<std::string>();
+            entry.gpioNum = obj["GpioNum"].get<int>();
 
-            lineMsg += chipIdStr + " " + std::to_string(gpioNum);
-
-            /* Get the GPIO line */
-            line = gpiod_line_get(chipIdStr.c_str(), gpioNum);
+            entry.lineMsg +=
+                entry.chipId + " " + std::to_string(entry.gpioNum);
         }
         else
         {
-            /* Find the GPIO line */
-            std::string lineName = obj["LineName"].get<std::string>();
-            lineMsg += lineName;
-            line = gpiod_line_find(lineName.c_str());
-        }
-
-        if (line == nullptr)
-        {
-            lg2::error("Failed to find the {GPIO}", "GPIO", lineMsg);
-            continue;
+            entry.lineName = obj["LineName"].get<std::string>();
+            entry.lineMsg += entry.lineName;
         }
 
         /* Parse out inventory argument. */
@@ -129,7 +205,7 @@ int main(int argc, char** argv)
         }
         else
         {
-            inventory = obj["Inventory"].get<std::string>();
+            entry.inventory = obj["Inventory"].get<std::string>();
         }
 
         if (obj.find("Name") == obj.end())
@@ -139,7 +215,7 @@ int main(int argc, char** argv)
         }
         else
         {
-            name = obj["Name"].get<std::string>();
+            entry.name = obj["Name"].get<std::string>();
         }
 
         /* Parse optional bias */
@@ -166,13 +242,96 @@ int main(int argc, char** argv)
         /* Parse optional extra interfaces */
         if (obj.find("ExtraInterfaces") != obj.end())
         {
-            obj.at("ExtraInterfaces").get_to(extraInterfaces);
+            obj.at("ExtraInterfaces").get_to(entry.extraInterfaces);
+        }
+
+        try
+        {
+            entry.logLimits = phosphor::gpio::ratelimit::parse(obj);
         }
+        catch (const std::invalid_argument& e)
+        {
+            lg2::error("{GPIO}: invalid LogRateLimit: {ERROR}", "GPIO", lineMsg,
+                       "ERROR", e);
+            return -1;
+        }
+        entry.poll = obj.value("Poll", false);
+        entry.actionQueue = &actionQueue;
 
-        /* Create a monitor object and let it do all the rest */
-        gpios.push_back(phosphor::gpio::GpioPresence(
-            line, config, io, inventory, extraInterfaces, name, lineMsg));
+        entries.push_back(std::move(entry));
     }
+
+    configPhase.end();
+
+    phosphor::gpio::LineInfoWatcher lineWatcher(io, "gpio_monitor");
+
+    auto acquirePending = [&]() {
+        phosphor::gpio::acquirePending(
+            entries, poller, lineWatcher,
+            [&io](phosphor::gpio::PresenceEntry& entry) {
+                phosphor::gpio::startMonitor(entry, io);
+            });
+    };
+
+    /* Watch before the first lookup so no chip is missed in between */
+    phosphor::gpio::ChipWatcher chipWatcher(
+        io, [&](const std::string& chip, bool added) {
+            if (added)
+            {
+                acquirePending();
+            }
+            else
+            {
+                phosphor::gpio::releaseChip(entries, chip, io, poller,
+                                            lineWatcher);
+            }
+        });
+
+    acquirePending();
+
+    for (const auto& entry : entries)
+    {
+        if (!entry.gpio)
+        {
+            lg2::info("Failed to find the {GPIO}, waiting for its chip",
+                      "GPIO", entry.lineMsg);
+        }
+    }
+
+    /* The state of all lines in one call, without reading them */
+    auto snapshot = phosphor::gpio::addSnapshot(server, [&entries]() {
+        std::vector<phosphor::gpio::LineSnapshot> lines;
+        lines.reserve(entries.size());
+        for (const auto& entry : entries)
+        {
+            if (entry.gpio)
+            {
+                lines.emplace_back(entry.name, entry.gpio->value(),
+                                   entry.gpio->lastChange());
+            }
+            else
+            {
+                lines.emplace_back(entry.name, -1, 0);
+            }
+        }
+        return lines;
+    });
+    conn->request_name(phosphor::gpio::busName);
+
+    /* Every line found is armed and its inventory item published */
+    phosphor::gpio::startup::ready();
+
+    boost::asio::steady_timer logSummaryTimer(io);
+    phosphor::gpio::ratelimit::schedule(logSummaryTimer);
+
+    /* Measure the loop lag and ping the systemd watchdog */
+    boost::asio::steady_timer loopLagTimer(io);
+    phosphor::gpio::looplag::schedule(loopLagTimer);
+
+    boost::asio::signal_set profileSignals(io,
+                                           phosphor::gpio::profile::dumpSignal);
+    phosphor::gpio::profile::schedule(profileSignals);
+
     io.run();
 
     return 0;
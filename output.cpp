@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "output.hpp"
+
+#include "trace.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+std::chrono::nanoseconds OutputLine::Stats::add(const timespec& edge,
+                                                const timespec& written)
+{
+    auto latency = std::chrono::seconds(written.tv_sec - edge.tv_sec) +
+                   std::chrono::nanoseconds(written.tv_nsec - edge.tv_nsec);
+
+    actions++;
+    total += latency;
+    max = std::max(max, latency);
+
+    return latency;
+}
+
+std::chrono::nanoseconds OutputLine::Stats::mean() const
+{
+    if (actions == 0)
+    {
+        return std::chrono::nanoseconds(0);
+    }
+    return total / static_cast<int64_t>(actions);
+}
+
+OutputLine::~OutputLine()
+{
+    if (line != nullptr)
+    {
+        gpiod_line_close_chip(line);
+    }
+}
+
+std::optional<OutputLine::Action> OutputLine::parseAction(
+    const std::string& action)
+{
+    if (action == "Set")
+    {
+        return Action::set;
+    }
+    if (action == "Clear")
+    {
+        return Action::clear;
+    }
+    if (action == "Mirror")
+    {
+        return Action::mirror;
+    }
+    if (action == "Pulse")
+    {
+        return Action::pulse;
+    }
+    return std::nullopt;
+}
+
+int OutputLine::request(gpiod_line* line, int flags, int initial)
+{
+    gpiod_line_request_config config{
+        "gpio_monitor", GPIOD_LINE_REQUEST_DIRECTION_OUTPUT, flags};
+
+    if (gpiod_line_request(line, &config, initial) < 0)
+    {
+        lg2::error("Failed to request output {GPIO}: {ERROR}", "GPIO",
+                   lineMsg, "ERROR", strerror(errno));
+        gpiod_line_close_chip(line);
+        return -1;
+    }
+    this->line = line;
+
+    lg2::info("{GPIO} output requested, initial value {VALUE}", "GPIO",
+              lineMsg, "VALUE", initial);
+    return 0;
+}
+
+void OutputLine::run(Action action, std::chrono::microseconds width,
+                     bool blocking, bool value, const timespec& ts)
+{
+    bool timed = action == Action::pulse && !blocking;
+    if (!timed)
+    {
+        /* The end of a pending pulse would undo this action */
+        timer.cancel();
+    }
+
+    int driven = 1;
+    switch (action)
+    {
+        case Action::clear:
+            driven = 0;
+            break;
+        case Action::mirror:
+            driven = value;
+            break;
+        case Action::set:
+        case Action::pulse:
+        default:
+            break;
+    }
+
+    if (!write(driven))
+    {
+        return;
+    }
+    timespec written{};
+    clock_gettime(CLOCK_MONOTONIC, &written);
+
+    auto latency = stats.add(ts, written);
+    GPIO_TRACE(output_set, lineMsg.c_str(), driven,
+               static_cast<long long>(latency.count()));
+
+    if (action != Action::pulse)
+    {
+        return;
+    }
+
+    /* Pulses too short for the event loop are timed here */
+    if (blocking)
+    {
+        auto end = written;
+        end.tv_nsec += std::chrono::nanoseconds(width).count();
+        end.tv_sec += end.tv_nsec / 1000000000;
+        end.tv_nsec %= 1000000000;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &end,
+                               nullptr) == EINTR)
+        {}
+        write(0);
+        return;
+    }
+
+    /* A pulse retriggered before its end is extended */
+    timer.expires_after(width);
+    timer.async_wait([this](const boost::system::error_code& ec) {
+        if (ec)
+        {
+            return;
+        }
+        write(0);
+    });
+}
+
+bool OutputLine::write(int value)
+{
+    if (gpiod_line_set_value(line, value) < 0)
+    {
+        ratelimit::error(logLimit, "Failed to set {GPIO} to {VALUE}: {ERROR}",
+                         "GPIO", lineMsg, "VALUE", value, "ERROR",
+                         strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void OutputLine::dumpStats() const
+{
+    if (stats.actions == 0)
+    {
+        return;
+    }
+
+    auto meanUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(stats.mean())
+            .count();
+    auto maxUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(stats.max)
+            .count();
+    lg2::info("{GPIO} driven {COUNT} times, edge to output mean {MEAN_US} us, "
+              "max {MAX_US} us",
+              "GPIO", lineMsg, "COUNT", stats.actions, "MEAN_US", meanUs,
+              "MAX_US", maxUs);
+}
+
+} // namespace gpio
+} // namespace phosphor
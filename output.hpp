@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include "ratelimit.hpp"
+
+#include <gpiod.h>
+#include <time.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @class OutputLine
+ *  @brief Output line driven from the event handlers of other lines.
+ *
+ *  The line is requested at startup and written directly on an edge, so a
+ *  reflex like mirroring a button to an LED does not wait for a unit to
+ *  run gpioset. The time from the edge to the write is measured on every
+ *  action.
+ */
+class OutputLine
+{
+  public:
+    /** @brief What an edge does to the output */
+    enum class Action
+    {
+        set,
+        clear,
+        mirror,
+        pulse,
+    };
+
+    /** @brief Longest pulse that may be timed in the event handler, which
+     *         blocks meanwhile; other pulses end from a timer */
+    static constexpr auto maxBlockingPulse = std::chrono::microseconds(100);
+
+    /** @brief Edge to output latency of the actions */
+    struct Stats
+    {
+        uint64_t actions = 0;
+        std::chrono::nanoseconds total{0};
+        std::chrono::nanoseconds max{0};
+
+        /** @brief Counts an action
+         *
+         *  @param[in] edge    - kernel timestamp of the edge, CLOCK_MONOTONIC
+         *  @param[in] written - time of the write, CLOCK_MONOTONIC
+         *
+         *  @return the latency of the action
+         */
+        std::chrono::nanoseconds add(const timespec& edge,
+                                     const timespec& written);
+
+        /** @brief Returns the mean latency, 0 before the first action */
+        std::chrono::nanoseconds mean() const;
+    };
+
+    OutputLine() = delete;
+    ~OutputLine();
+    OutputLine(const OutputLine&) = delete;
+    OutputLine& operator=(const OutputLine&) = delete;
+    OutputLine(OutputLine&&) = delete;
+    OutputLine& operator=(OutputLine&&) = delete;
+
+    /** @brief Constructs OutputLine object.
+     *
+     *  @param[in] io      - io service running the pulse timer
+     *  @param[in] lineMsg - GPIO line message used for log
+     */
+    OutputLine(boost::asio::io_context& io, const std::string& lineMsg) :
+        lineMsg(lineMsg), logLimit(ratelimit::get(lineMsg)), timer(io)
+    {}
+
+    /** @brief Parses the action of the config file: Set, Clear, Mirror or
+     *         Pulse
+     */
+    static std::optional<Action> parseAction(const std::string& action);
+
+    /** @brief Requests the line as output, the object closes its chip
+     *
+     *  @param[in] line    - GPIO line from libgpiod, with its own chip
+     *  @param[in] flags   - GPIOD_LINE_REQUEST_FLAG_* of the line
+     *  @param[in] initial - value driven until the first action
+     *
+     *  @return 0 on success, -1 otherwise
+     */
+    int request(gpiod_line* line, int flags, int initial);
+
+    /** @brief Drives the output for an edge of another line
+     *
+     *  Any action ends a pending pulse, a pulse retriggered before its end
+     *  is extended.
+     *
+     *  @param[in] action   - what the edge does to the output
+     *  @param[in] width    - pulse width of Pulse
+     *  @param[in] blocking - whether the pulse is timed in the event
+     *                        handler, up to maxBlockingPulse
+     *  @param[in] value    - new value of the line of the edge
+     *  @param[in] ts       - kernel timestamp of the edge, CLOCK_MONOTONIC
+     */
+    void run(Action action, std::chrono::microseconds width, bool blocking,
+             bool value, const timespec& ts);
+
+    /** @brief Returns the edge to output latency of the actions run */
+    const Stats& statistics() const
+    {
+        return stats;
+    }
+
+    /** @brief Logs the number of actions and their edge to output latency
+     */
+    void dumpStats() const;
+
+  private:
+    /** @brief Writes the output
+     *
+     *  @return false if the write failed
+     */
+    bool write(int value);
+
+    const std::string lineMsg;
+    ratelimit::Limiter& logLimit;
+    gpiod_line* line = nullptr;
+
+    /** @brief Ends the pulses not timed in the event handler */
+    boost::asio::steady_timer timer;
+
+    Stats stats;
+};
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,273 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "poller.hpp"
+
+#include "loop_lag.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+namespace
+{
+
+/** @brief Returns the CPU time used by the calling thread */
+std::chrono::nanoseconds threadCpuTime()
+{
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return std::chrono::seconds(ts.tv_sec) +
+           std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+} // namespace
+
+int LinePoller::addLine(gpiod_line* line, int flags,
+                        const std::string& lineMsg, Callback callback)
+{
+    std::string name = gpiod_chip_name(gpiod_line_get_chip(line));
+
+    /* Requested groups cannot grow, late lines start a new one */
+    auto group = std::find_if(groups.begin(), groups.end(), [&](auto& g) {
+        return !g->started && g->name == name && g->flags == flags &&
+               g->bulk.num_lines < GPIOD_LINE_BULK_MAX_LINES;
+    });
+    if (group == groups.end())
+    {
+        auto* chip = gpiod_chip_open_by_name(name.c_str());
+        if (chip == nullptr)
+        {
+            lg2::error("Failed to open {CHIP} to poll {GPIO}: {ERROR}", "CHIP",
+                       name, "GPIO", lineMsg, "ERROR", strerror(errno));
+            return -1;
+        }
+
+        group = groups.insert(groups.end(),
+                              std::make_shared<Group>(io, chip, name, flags));
+    }
+
+    gpiod_line_bulk_add(&(*group)->bulk,
+                        gpiod_chip_get_line((*group)->chip,
+                                            gpiod_line_offset(line)));
+    (*group)->lineMsgs.push_back(lineMsg);
+    (*group)->callbacks.push_back(std::move(callback));
+
+    return 0;
+}
+
+int LinePoller::start()
+{
+    int result = 0;
+
+    for (auto it = groups.begin(); it != groups.end();)
+    {
+        if ((*it)->started)
+        {
+            ++it;
+            continue;
+        }
+
+        /* A line held by another consumer fails the whole group, it is
+         * requested again until it is free */
+        if (start(*it) < 0)
+        {
+            result = -1;
+            scheduleRetry(*it);
+        }
+        ++it;
+    }
+
+    if (!groups.empty() && !reporting)
+    {
+        reporting = true;
+        reportStart = std::chrono::steady_clock::now();
+        scheduleReport();
+    }
+
+    return result;
+}
+
+int LinePoller::start(const std::shared_ptr<Group>& group)
+{
+    gpiod_line_request_config request{
+        "gpio_monitor", GPIOD_LINE_REQUEST_DIRECTION_INPUT, group->flags};
+
+    if (gpiod_line_request_bulk(&group->bulk, &request, nullptr) < 0)
+    {
+        if (group->retries == 0)
+        {
+            lg2::error("Failed to request {COUNT} lines of {CHIP} for "
+                       "polling: {ERROR}, retrying",
+                       "COUNT", group->bulk.num_lines, "CHIP", group->name,
+                       "ERROR", strerror(errno));
+        }
+        return -1;
+    }
+
+    group->values.resize(group->bulk.num_lines);
+    if (gpiod_line_get_value_bulk(&group->bulk, group->values.data()) < 0)
+    {
+        if (group->retries == 0)
+        {
+            lg2::error("Failed to read the lines of {CHIP}: {ERROR}, "
+                       "retrying",
+                       "CHIP", group->name, "ERROR", strerror(errno));
+        }
+        gpiod_line_release_bulk(&group->bulk);
+        return -1;
+    }
+    group->started = true;
+
+    if (group->retries > 0)
+    {
+        lg2::info("Requested {COUNT} lines of {CHIP} for polling after "
+                  "{RETRIES} retries",
+                  "COUNT", group->bulk.num_lines, "CHIP", group->name,
+                  "RETRIES", group->retries);
+    }
+
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    for (size_t i = 0; i < group->values.size(); i++)
+    {
+        lg2::info("{GPIO} has no edge events, polling started", "GPIO",
+                  group->lineMsgs[i]);
+        group->callbacks[i](group->values[i] != 0, now);
+    }
+
+    group->interval = config.minInterval;
+    schedule(group);
+
+    return 0;
+}
+
+void LinePoller::removeChip(const std::string& chip)
+{
+    std::erase_if(groups, [&chip](auto& group) {
+        if (group->name != chip)
+        {
+            return false;
+        }
+        group->timer.cancel();
+        return true;
+    });
+}
+
+void LinePoller::schedule(const std::shared_ptr<Group>& group)
+{
+    group->timer.expires_after(group->interval);
+    group->timer.async_wait(
+        [this, weak = std::weak_ptr<Group>(group)](
+            const boost::system::error_code& ec) {
+            auto group = weak.lock();
+            if (ec || !group)
+            {
+                return;
+            }
+            poll(*group);
+            schedule(group);
+        });
+}
+
+void LinePoller::scheduleRetry(const std::shared_ptr<Group>& group)
+{
+    group->timer.expires_after(config.maxInterval);
+    group->timer.async_wait(
+        [this, weak = std::weak_ptr<Group>(group)](
+            const boost::system::error_code& ec) {
+            auto group = weak.lock();
+            if (ec || !group || group->started)
+            {
+                return;
+            }
+            group->retries++;
+            if (start(group) < 0)
+            {
+                scheduleRetry(group);
+            }
+        });
+}
+
+void LinePoller::poll(Group& group)
+{
+    looplag::Scope scope("GPIO poll", group.name);
+    auto cpuStart = threadCpuTime();
+
+    /* Reads all the lines of the group with one ioctl */
+    std::array<int, GPIOD_LINE_BULK_MAX_LINES> values{};
+    if (gpiod_line_get_value_bulk(&group.bulk, values.data()) < 0)
+    {
+        lg2::error("Failed to read the lines of {CHIP}: {ERROR}", "CHIP",
+                   group.name, "ERROR", strerror(errno));
+        group.interval = config.maxInterval;
+        return;
+    }
+
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    bool changed = false;
+    for (size_t i = 0; i < group.values.size(); i++)
+    {
+        if (values[i] != group.values[i])
+        {
+            group.values[i] = values[i];
+            changed = true;
+            group.callbacks[i](values[i] != 0, now);
+        }
+    }
+
+    /* Fast right after a change, backing off while idle */
+    group.interval = changed ? config.minInterval
+                             : std::min(group.interval * 2, config.maxInterval);
+
+    group.polls++;
+    group.cpuTime += threadCpuTime() - cpuStart;
+}
+
+void LinePoller::scheduleReport()
+{
+    reportTimer.expires_after(config.reportInterval);
+    reportTimer.async_wait([this](const boost::system::error_code& ec) {
+        if (ec)
+        {
+            return;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        auto elapsed =
+            std::chrono::duration<double>(now - reportStart).count();
+        reportStart = now;
+
+        for (auto& group : groups)
+        {
+            auto cpuUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                             group->cpuTime)
+                             .count();
+            lg2::info("Polled {COUNT} lines of {CHIP} {POLLS} times using "
+                      "{CPU_US} us CPU ({LOAD} %), interval {INTERVAL} ms",
+                      "COUNT", group->bulk.num_lines, "CHIP", group->name,
+                      "POLLS", group->polls,
+                      "CPU_US", cpuUs, "LOAD",
+                      elapsed > 0 ? cpuUs / elapsed / 1e4 : 0.0, "INTERVAL",
+                      group->interval.count());
+            group->polls = 0;
+            group->cpuTime = std::chrono::nanoseconds(0);
+        }
+
+        scheduleReport();
+    });
+}
+
+} // namespace gpio
+} // namespace phosphor
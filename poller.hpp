@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <gpiod.h>
+#include <time.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @class LinePoller
+ *  @brief Polls the lines that cannot deliver edge events.
+ *
+ *  Lines of some GPIO expanders have no interrupt. Such lines are grouped
+ *  per chip and request flags, and each group is read with one bulk read
+ *  per tick. The interval of a group drops to the minimum when one of its
+ *  lines changed and doubles on every idle tick up to the maximum, so an
+ *  idle expander costs little while a busy one is sampled quickly.
+ *
+ *  The CPU time spent polling is logged periodically.
+ */
+class LinePoller
+{
+  public:
+    /** @brief Called with the initial value of a line, then on every change
+     *  with the CLOCK_MONOTONIC time of the read that saw it
+     */
+    using Callback = std::function<void(bool value, const timespec& ts)>;
+
+    struct Config
+    {
+        /** @brief Interval right after a change */
+        std::chrono::milliseconds minInterval{10};
+        /** @brief Interval reached when idle */
+        std::chrono::milliseconds maxInterval{1000};
+        /** @brief Time between two CPU cost reports */
+        std::chrono::seconds reportInterval{60};
+    };
+
+    LinePoller() = delete;
+    ~LinePoller() = default;
+    LinePoller(const LinePoller&) = delete;
+    LinePoller& operator=(const LinePoller&) = delete;
+    LinePoller(LinePoller&&) = delete;
+    LinePoller& operator=(LinePoller&&) = delete;
+
+    /** @brief Constructs LinePoller object.
+     *
+     *  @param[in] io     - io service running the poll timers
+     *  @param[in] config - poll intervals
+     */
+    LinePoller(boost::asio::io_context& io, const Config& config) :
+        io(io), config(config), reportTimer(io)
+    {}
+
+    /** @brief Adds a line to poll, it is requested by the next start()
+     *
+     *  The poller opens its own handle of the chip, so that lines found
+     *  separately can be read together.
+     *
+     *  @param[in] line     - GPIO line from libgpiod, not requested
+     *  @param[in] flags    - GPIOD_LINE_REQUEST_FLAG_* of the line
+     *  @param[in] lineMsg  - GPIO line message used for log
+     *  @param[in] callback - called with the line value
+     *
+     *  @return 0 on success, -1 if the chip could not be opened
+     */
+    int addLine(gpiod_line* line, int flags, const std::string& lineMsg,
+                Callback callback);
+
+    /** @brief Requests the lines added since the last call as inputs,
+     *         reports their initial values and starts polling them
+     *
+     *  A group of lines which could not be requested, for example because
+     *  another consumer holds one of them, is requested again every
+     *  maximum interval.
+     *
+     *  @return 0 on success, -1 if a group of lines could not be requested
+     */
+    int start();
+
+    /** @brief Stops polling the lines of a chip which was removed
+     *
+     *  @param[in] chip - device name of the chip, for example gpiochip3
+     */
+    void removeChip(const std::string& chip);
+
+  private:
+    /** @brief Lines of a chip requested together */
+    struct Group
+    {
+        Group(boost::asio::io_context& io, gpiod_chip* chip,
+              const std::string& name, int flags) :
+            chip(chip), name(name), flags(flags), timer(io)
+        {
+            gpiod_line_bulk_init(&bulk);
+        }
+
+        ~Group()
+        {
+            gpiod_chip_close(chip);
+        }
+
+        Group(const Group&) = delete;
+        Group& operator=(const Group&) = delete;
+
+        /** @brief Handle of the chip owned by the group */
+        gpiod_chip* chip;
+        /** @brief Device name of the chip, for example gpiochip3 */
+        std::string name;
+        int flags;
+        gpiod_line_bulk bulk;
+        std::vector<std::string> lineMsgs;
+        std::vector<Callback> callbacks;
+        /** @brief Last values read, indexed like the bulk */
+        std::vector<int> values;
+        std::chrono::milliseconds interval{0};
+        boost::asio::steady_timer timer;
+
+        /** @brief Whether the lines were requested */
+        bool started = false;
+
+        /** @brief Failed requests since the first one */
+        uint64_t retries = 0;
+
+        /** @brief Reads and CPU time since the last report */
+        uint64_t polls = 0;
+        std::chrono::nanoseconds cpuTime{0};
+    };
+
+    /** @brief Requests the lines of a group and starts polling them
+     *
+     *  @return 0 on success, -1 otherwise
+     */
+    int start(const std::shared_ptr<Group>& group);
+
+    /** @brief Requests a group again after the maximum interval */
+    void scheduleRetry(const std::shared_ptr<Group>& group);
+
+    /** @brief Schedules the next read of a group */
+    void schedule(const std::shared_ptr<Group>& group);
+
+    /** @brief Reads a group and reports its changes */
+    void poll(Group& group);
+
+    /** @brief Logs the CPU cost of the polling periodically */
+    void scheduleReport();
+
+    boost::asio::io_context& io;
+    const Config config;
+    /** @brief Groups of lines, the timers only keep weak references so a
+     *         removed chip can be dropped at any time */
+    std::vector<std::shared_ptr<Group>> groups;
+    boost::asio::steady_timer reportTimer;
+    bool reporting = false;
+
+    /** @brief Start of the current report period */
+    std::chrono::steady_clock::time_point reportStart;
+};
+
+} // namespace gpio
+} // namespace phosphor
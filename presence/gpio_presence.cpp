@@ -3,6 +3,9 @@
 
 #include "gpio_presence.hpp"
 
+#include "loop_lag.hpp"
+#include "startup.hpp"
+#include "trace.hpp"
 #include "xyz/openbmc_project/Common/error.hpp"
 
 #include <fcntl.h>
@@ -43,6 +46,7 @@ std::string getService(const std::string& path, const std::string& interface,
     std::map<std::string, std::vector<std::string>> mapperResponse;
     try
     {
+        profile::Blocked blocked;
         auto mapperResponseMsg = bus.call(mapperCall);
         mapperResponseMsg.read(mapperResponse);
     }
@@ -59,6 +63,7 @@ std::string getService(const std::string& path, const std::string& interface,
 
 void Presence::determinePresence()
 {
+    startup::Phase dispatch("initial dispatch");
     auto present = false;
     auto value = static_cast<int>(0);
     auto fetch_rc =
@@ -83,6 +88,7 @@ int Presence::processEvents(sd_event_source*, int, uint32_t, void* userData)
 {
     auto presence = static_cast<Presence*>(userData);
 
+    looplag::Scope scope("GPIO presence event", presence->inventory);
     presence->analyzeEvent();
     return 0;
 }
@@ -90,6 +96,8 @@ int Presence::processEvents(sd_event_source*, int, uint32_t, void* userData)
 // Analyzes the GPIO event
 void Presence::analyzeEvent()
 {
+    profile::Handler cost(profileId);
+
     // Data returned
     struct input_event ev{};
     int rc = 0;
@@ -116,6 +124,10 @@ void Presence::analyzeEvent()
             }
             else if (ev.code == key)
             {
+                GPIO_TRACE(event_read, path.c_str(), ev.value,
+                           ev.input_event_sec * 1000000000ULL +
+                               ev.input_event_usec * 1000ULL);
+
                 auto present = false;
                 if (ev.value > 0)
                 {
@@ -160,7 +172,8 @@ void Presence::updateInventory(bool present)
 {
     ObjectMap invObj = getObjectMap(present);
 
-    lg2::info(
+    ratelimit::info(
+        logLimit,
         "Updating inventory present property value to {PRESENT}, path: {PATH}",
         "PRESENT", present, "PATH", inventory);
 
@@ -170,12 +183,16 @@ void Presence::updateInventory(bool present)
     auto invMsg = bus.new_method_call(invService.c_str(), INVENTORY_PATH,
                                       INVENTORY_INTF, "Notify");
     invMsg.append(std::move(invObj));
+    GPIO_TRACE(inventory_update, inventory.c_str(), present);
     try
     {
+        profile::Blocked blocked;
         auto invMgrResponseMsg = bus.call(invMsg);
+        GPIO_TRACE(inventory_ack, inventory.c_str(), 0);
     }
     catch (const sdbusplus::exception_t& e)
     {
+        GPIO_TRACE(inventory_ack, inventory.c_str(), -e.get_errno());
         lg2::error(
             "Error in inventory manager call to update inventory: {ERROR}",
             "ERROR", e);
@@ -194,13 +211,13 @@ void Presence::bindOrUnbindDrivers(bool present)
 
         if (present)
         {
-            lg2::info("Binding a {DEVICE} driver: {PATH}", "DEVICE", device,
-                      "PATH", path);
+            ratelimit::info(logLimit, "Binding a {DEVICE} driver: {PATH}",
+                            "DEVICE", device, "PATH", path);
         }
         else
         {
-            lg2::info("Unbinding a {DEVICE} driver: {PATH}", "DEVICE", device,
-                      "PATH", path);
+            ratelimit::info(logLimit, "Unbinding a {DEVICE} driver: {PATH}",
+                            "DEVICE", device, "PATH", path);
         }
 
         std::ofstream file;
@@ -216,7 +233,8 @@ void Presence::bindOrUnbindDrivers(bool present)
         }
         catch (const std::exception& e)
         {
-            lg2::error(
+            ratelimit::error(
+                logLimit,
                 "Failed binding or unbinding a {DEVICE} after a card was removed or added, path: {PATH}, error: {ERROR}",
                 "DEVICE", device, "PATH", path, "ERROR", e);
         }
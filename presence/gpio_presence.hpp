@@ -3,6 +3,8 @@
 
 #pragma once
 #include "evdev.hpp"
+#include "line_profile.hpp"
+#include "ratelimit.hpp"
 
 #include <systemd/sd-event.h>
 
@@ -75,7 +77,9 @@ class Presence : public Evdev
              const std::vector<Interface>& ifaces,
              sd_event_io_handler_t handler = Presence::processEvents) :
         Evdev(path, key, event, handler, true), bus(bus), inventory(inventory),
-        name(name), drivers(drivers), ifaces(ifaces)
+        name(name), drivers(drivers), ifaces(ifaces),
+        logLimit(ratelimit::get(path + " key " + std::to_string(key))),
+        profileId(profile::addLine(inventory))
     {
         // See if the environment (from configuration file?) has a
         // DRIVER_BIND_DELAY_MS set.
@@ -148,6 +152,12 @@ class Presence : public Evdev
      */
     const std::vector<Interface> ifaces;
 
+    /** @brief Rate limiter of the hot path log messages */
+    ratelimit::Limiter& logLimit;
+
+    /** @brief Id of the item in the handler profile */
+    uint32_t profileId;
+
     /**
      * @brief Binds or unbinds drivers
      *
@@ -2,6 +2,10 @@
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 
 #include "gpio_presence.hpp"
+#include "line_profile.hpp"
+#include "loop_lag.hpp"
+#include "ratelimit.hpp"
+#include "startup.hpp"
 
 #include <systemd/sd-event.h>
 
@@ -62,6 +66,8 @@ static int getDrivers(const std::string& driverString,
 
 int main(int argc, char** argv)
 {
+    phosphor::gpio::startup::Phase configPhase("config");
+
     CLI::App app{"Monitor gpio presence status"};
 
     std::string path{};
@@ -70,6 +76,8 @@ int main(int argc, char** argv)
     std::string inventory{};
     std::string drivers{};
     std::string ifaces{};
+    phosphor::gpio::ratelimit::Config logConfig;
+    phosphor::gpio::looplag::Config lagConfig;
 
     /* Add an input option */
     app.add_option(
@@ -94,6 +102,16 @@ int main(int argc, char** argv)
            "Format is a comma separated list of interfaces.\n"
            "For example: /xyz/openbmc_project/.../1,/xyz/openbmc_project/.../2")
         ->expected(0, 1);
+    app.add_option("--log-rate", logConfig.defaults.rate,
+                   "Log messages per second allowed per message")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--log-burst", logConfig.defaults.burst,
+                   "Log messages allowed in a burst per message")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--log-summary-interval", logConfig.summaryInterval,
+                   "Seconds between suppressed log message summaries")
+        ->check(CLI::PositiveNumber);
+    phosphor::gpio::looplag::addOptions(app, lagConfig);
 
     /* Parse input parameter */
     try
@@ -105,6 +123,9 @@ int main(int argc, char** argv)
         return app.exit(e);
     }
 
+    phosphor::gpio::ratelimit::configure(logConfig);
+    phosphor::gpio::looplag::configure(lagConfig);
+
     std::vector<Driver> driverList;
 
     // Driver list is optional
@@ -131,6 +152,8 @@ int main(int argc, char** argv)
         }
     }
 
+    configPhase.end();
+
     auto bus = sdbusplus::bus::new_default();
     auto rc = 0;
     sd_event* event = nullptr;
@@ -143,8 +166,34 @@ int main(int argc, char** argv)
     EventPtr eventP{event};
     event = nullptr;
 
+    // Log the suppressed message summaries periodically
+    rc = phosphor::gpio::ratelimit::attach(eventP.get());
+    if (rc < 0)
+    {
+        return rc;
+    }
+
+    // Measure the loop lag and ping the systemd watchdog
+    rc = phosphor::gpio::looplag::attach(eventP.get());
+    if (rc < 0)
+    {
+        return rc;
+    }
+
+    // Dump the costliest lines on SIGUSR1
+    rc = phosphor::gpio::profile::attach(eventP.get());
+    if (rc < 0)
+    {
+        return rc;
+    }
+
+    phosphor::gpio::startup::Phase request("request");
     Presence presence(bus, inventory, path, std::stoul(key), name, eventP,
                       driverList, ifaceList);
+    request.end();
+
+    /* The inventory item is published with its initial presence */
+    phosphor::gpio::startup::ready();
 
     while (true)
     {
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "pulse_meter.hpp"
+
+#include <algorithm>
+#include <optional>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+void PulseMeter::edge(bool value, Clock::time_point time)
+{
+    if (count == ring.size())
+    {
+        pop();
+    }
+
+    ring[(head + count) % ring.size()] = {time, value};
+    count++;
+}
+
+void PulseMeter::pop()
+{
+    level = ring[head].value;
+    levelSince = ring[head].time;
+    head = (head + 1) % ring.size();
+    count--;
+}
+
+Measurement PulseMeter::measure(Clock::time_point now)
+{
+    auto start = now - window;
+    while (count > 0 && ring[head].time < start)
+    {
+        pop();
+    }
+
+    Measurement result;
+    result.edges = count;
+
+    if (count == 0)
+    {
+        result.dutyCycle = level > 0 ? 100.0 : 0.0;
+        return result;
+    }
+
+    /* Without a level before the window, the window starts at the first
+     * edge, which is the case until the first window is full. When the
+     * ring dropped edges of the window, it starts at the last one dropped.
+     */
+    auto last = std::max(start, levelSince);
+    bool high = level > 0;
+    if (level < 0)
+    {
+        last = ring[head].time;
+        high = !ring[head].value;
+    }
+    auto span = now - last;
+
+    Clock::duration highTime{};
+    std::optional<Clock::time_point> rise;
+    uint64_t rising = 0;
+    std::optional<Clock::duration> minPulse;
+    Clock::duration maxPulse{};
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto& edge = ring[(head + i) % ring.size()];
+
+        if (high)
+        {
+            highTime += edge.time - last;
+        }
+
+        if (edge.value && !high)
+        {
+            rising++;
+            rise = edge.time;
+        }
+        else if (!edge.value && high && rise)
+        {
+            auto width = edge.time - *rise;
+            minPulse = std::min(minPulse.value_or(width), width);
+            maxPulse = std::max(maxPulse, width);
+        }
+
+        high = edge.value;
+        last = edge.time;
+    }
+
+    if (high)
+    {
+        highTime += now - last;
+    }
+
+    if (span.count() > 0)
+    {
+        result.frequency =
+            rising / std::chrono::duration<double>(span).count();
+        result.dutyCycle = 100.0 * highTime / span;
+    }
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    result.minPulseWidth =
+        duration_cast<microseconds>(minPulse.value_or(Clock::duration{}))
+            .count();
+    result.maxPulseWidth = duration_cast<microseconds>(maxPulse).count();
+
+    return result;
+}
+
+} // namespace gpio
+} // namespace phosphor
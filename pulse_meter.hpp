@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @brief Statistics of the edges of a line over a sliding window */
+struct Measurement
+{
+    /** @brief Edges in the window */
+    uint64_t edges = 0;
+    /** @brief Rising edges per second */
+    double frequency = 0.0;
+    /** @brief Percentage of the window the line was high */
+    double dutyCycle = 0.0;
+    /** @brief Shortest high pulse in the window, in microseconds */
+    uint64_t minPulseWidth = 0;
+    /** @brief Longest high pulse in the window, in microseconds */
+    uint64_t maxPulseWidth = 0;
+};
+
+/** @class PulseMeter
+ *  @brief Measures frequency, duty cycle and pulse widths of a line.
+ *
+ *  Edges are kept in a fixed size ring, so recording an edge never
+ *  allocates. The statistics are only computed when they are requested.
+ *  When edges come in faster than the ring holds, the oldest ones are
+ *  dropped and the window effectively shrinks.
+ */
+class PulseMeter
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    PulseMeter() = delete;
+    ~PulseMeter() = default;
+    PulseMeter(const PulseMeter&) = delete;
+    PulseMeter& operator=(const PulseMeter&) = delete;
+    PulseMeter(PulseMeter&&) = delete;
+    PulseMeter& operator=(PulseMeter&&) = delete;
+
+    /** @brief Constructs PulseMeter object.
+     *
+     *  @param[in] window   - length of the sliding window
+     *  @param[in] capacity - maximum number of edges kept
+     */
+    PulseMeter(std::chrono::milliseconds window, size_t capacity) :
+        window(window), ring(capacity)
+    {}
+
+    /** @brief Records an edge
+     *
+     *  @param[in] value - new line value
+     *  @param[in] time  - kernel time of the edge
+     */
+    void edge(bool value, Clock::time_point time);
+
+    /** @brief Computes the statistics of the window ending now
+     *
+     *  @param[in] now - end of the window
+     */
+    Measurement measure(Clock::time_point now);
+
+  private:
+    struct Edge
+    {
+        Clock::time_point time;
+        bool value;
+    };
+
+    /** @brief Drops the oldest edge, remembering the level it set */
+    void pop();
+
+    /** @brief Length of the sliding window */
+    const std::chrono::milliseconds window;
+
+    /** @brief Edges of the window, oldest at head */
+    std::vector<Edge> ring;
+    size_t head = 0;
+    size_t count = 0;
+
+    /** @brief Line level before the oldest edge, -1 if it is unknown */
+    int level = -1;
+
+    /** @brief Time of the last dropped edge, which set the level */
+    Clock::time_point levelSince;
+};
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "ratelimit.hpp"
+
+#include <nlohmann/json.hpp>
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace ratelimit
+{
+
+namespace
+{
+
+Config settings;
+
+/* std::map keeps its nodes in place, handed out references stay valid */
+std::map<std::string, Limiter> limiters;
+
+uint64_t summaryIntervalUs()
+{
+    return settings.summaryInterval * 1000000ULL;
+}
+
+int summaryHandler(sd_event_source* source, uint64_t usec, void*)
+{
+    flushAll();
+
+    sd_event_source_set_time(source, usec + summaryIntervalUs());
+    sd_event_source_set_enabled(source, SD_EVENT_ONESHOT);
+
+    return 0;
+}
+
+} // namespace
+
+bool Limiter::allow(std::string_view site, Clock::time_point now)
+{
+    auto bucket = std::find_if(buckets.begin(), buckets.end(),
+                               [site](const auto& b) { return b.site == site; });
+    if (bucket == buckets.end())
+    {
+        buckets.push_back({site, static_cast<double>(limits.burst), now, 0});
+        bucket = buckets.end() - 1;
+    }
+
+    std::chrono::duration<double> elapsed = now - bucket->last;
+    bucket->last = now;
+    bucket->tokens = std::min(static_cast<double>(limits.burst),
+                              bucket->tokens + elapsed.count() * limits.rate);
+
+    if (bucket->tokens < 1.0)
+    {
+        bucket->suppressed++;
+        return false;
+    }
+
+    bucket->tokens -= 1.0;
+    return true;
+}
+
+void Limiter::flush()
+{
+    for (auto& bucket : buckets)
+    {
+        if (bucket.suppressed == 0)
+        {
+            continue;
+        }
+
+        lg2::warning("{GPIO}: {COUNT} messages suppressed: {MESSAGE}", "GPIO",
+                     line, "COUNT", bucket.suppressed, "MESSAGE",
+                     std::string(bucket.site));
+        bucket.suppressed = 0;
+    }
+}
+
+uint64_t Limiter::suppressed(std::string_view site) const
+{
+    auto bucket = std::find_if(buckets.begin(), buckets.end(),
+                               [site](const auto& b) { return b.site == site; });
+
+    return bucket == buckets.end() ? 0 : bucket->suppressed;
+}
+
+void configure(const Config& config)
+{
+    settings = config;
+}
+
+const Config& config()
+{
+    return settings;
+}
+
+Limiter& get(const std::string& line, const Limits& limits)
+{
+    return limiters.try_emplace(line, line, limits).first->second;
+}
+
+void flushAll()
+{
+    for (auto& [line, limiter] : limiters)
+    {
+        limiter.flush();
+    }
+}
+
+void schedule(boost::asio::steady_timer& timer)
+{
+    timer.expires_after(std::chrono::seconds(settings.summaryInterval));
+    timer.async_wait([&timer](const boost::system::error_code& ec) {
+        if (ec)
+        {
+            return;
+        }
+        flushAll();
+        schedule(timer);
+    });
+}
+
+int attach(sd_event* event)
+{
+    auto rc = sd_event_add_time_relative(event, nullptr, CLOCK_MONOTONIC,
+                                         summaryIntervalUs(), 0,
+                                         summaryHandler, nullptr);
+    if (rc < 0)
+    {
+        lg2::error("Failed to add log summary timer: {RC}", "RC", rc);
+    }
+
+    return rc;
+}
+
+Limits parse(const nlohmann::json& obj)
+{
+    Limits limits = settings.defaults;
+
+    auto limitObj = obj.find("LogRateLimit");
+    if (limitObj == obj.end())
+    {
+        return limits;
+    }
+    if (!limitObj->is_object())
+    {
+        throw std::invalid_argument("LogRateLimit is not an object");
+    }
+
+    auto rate = limitObj->find("Rate");
+    if (rate != limitObj->end())
+    {
+        if (!rate->is_number() || rate->get<double>() <= 0)
+        {
+            throw std::invalid_argument("Rate is not a positive number");
+        }
+        limits.rate = rate->get<double>();
+    }
+
+    auto burst = limitObj->find("Burst");
+    if (burst != limitObj->end())
+    {
+        /* Negative numbers are not unsigned in nlohmann::json */
+        if (!burst->is_number_unsigned() || burst->get<uint64_t>() < 1 ||
+            burst->get<uint64_t>() > std::numeric_limits<uint32_t>::max())
+        {
+            throw std::invalid_argument("Burst is not a positive integer");
+        }
+        limits.burst = burst->get<uint32_t>();
+    }
+
+    return limits;
+}
+
+} // namespace ratelimit
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <systemd/sd-event.h>
+
+#include <boost/asio/steady_timer.hpp>
+#include <nlohmann/json_fwd.hpp>
+#include <phosphor-logging/lg2.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace ratelimit
+{
+
+using Clock = std::chrono::steady_clock;
+
+/** @brief Token bucket settings of a line */
+struct Limits
+{
+    /** @brief Messages per second allowed per message site */
+    double rate = 5.0;
+
+    /** @brief Messages allowed in a burst per message site */
+    uint32_t burst = 10;
+};
+
+/** @brief Daemon wide settings */
+struct Config
+{
+    /** @brief Limits of lines without their own */
+    Limits defaults;
+
+    /** @brief Seconds between two suppressed message summaries */
+    uint32_t summaryInterval = 60;
+};
+
+/** @class Limiter
+ *  @brief Token bucket log rate limiter of one line.
+ *
+ *  A bucket is kept per message site, so a flood of one message does not
+ *  hide the others. A site is identified by its lg2 format string.
+ */
+class Limiter
+{
+  public:
+    Limiter() = delete;
+    ~Limiter() = default;
+    Limiter(const Limiter&) = delete;
+    Limiter& operator=(const Limiter&) = delete;
+    Limiter(Limiter&&) = default;
+    Limiter& operator=(Limiter&&) = delete;
+
+    /** @brief Constructs Limiter object.
+     *
+     *  @param[in] line   - line name used in the summaries
+     *  @param[in] limits - token bucket settings
+     */
+    Limiter(const std::string& line, const Limits& limits) :
+        line(line), limits(limits)
+    {}
+
+    /** @brief Takes a token for a message site.
+     *
+     *  @param[in] site - lg2 format string of the message
+     *  @param[in] now  - current time
+     *
+     *  @return true if the message may be logged, false if it has to be
+     *          dropped and counted as suppressed
+     */
+    bool allow(std::string_view site, Clock::time_point now = Clock::now());
+
+    /** @brief Logs and resets the suppressed message counts */
+    void flush();
+
+    /** @brief Returns the messages suppressed for a site since the last
+     *         flush
+     */
+    uint64_t suppressed(std::string_view site) const;
+
+  private:
+    struct Bucket
+    {
+        std::string_view site;
+        double tokens;
+        Clock::time_point last;
+        uint64_t suppressed;
+    };
+
+    /** @brief Line name used in the summaries */
+    const std::string line;
+
+    /** @brief Token bucket settings */
+    const Limits limits;
+
+    /** @brief One bucket per message site, there are only a few of them */
+    std::vector<Bucket> buckets;
+};
+
+/** @brief Sets the daemon wide settings, before any limiter is created */
+void configure(const Config& config);
+
+/** @brief Returns the daemon wide settings */
+const Config& config();
+
+/** @brief Returns the limiter of a line, creating it on first use.
+ *
+ *  Limiters live until the daemon exits, so the returned reference stays
+ *  valid when the object monitoring the line is moved.
+ *
+ *  @param[in] line   - line name used in the summaries
+ *  @param[in] limits - token bucket settings, only used on creation
+ */
+Limiter& get(const std::string& line, const Limits& limits = config().defaults);
+
+/** @brief Logs the suppressed message summaries of all lines.
+ *
+ *  Called by the daemons every Config::summaryInterval seconds.
+ */
+void flushAll();
+
+/** @brief Runs flushAll() every Config::summaryInterval seconds on an asio
+ *         loop
+ *
+ *  @param[in] timer - timer of the loop, kept by the caller
+ */
+void schedule(boost::asio::steady_timer& timer);
+
+/** @brief Runs flushAll() every Config::summaryInterval seconds on an
+ *         sd_event loop
+ *
+ *  @param[in] event - event loop, owns the timer source
+ *
+ *  @return 0 on success and negative errno otherwise
+ */
+int attach(sd_event* event);
+
+/** @brief Parses the optional LogRateLimit object of a config file entry
+ *
+ *  @param[in] obj - config file entry
+ *
+ *  @return the limits of the entry, the daemon defaults when it has none
+ *
+ *  @throw std::invalid_argument when Rate is not a positive number or
+ *         Burst is not a positive integer
+ */
+Limits parse(const nlohmann::json& obj);
+
+/** @brief Logs a message of a line unless its site is out of tokens.
+ *
+ *  The lg2 format string is also the message site, so it is written once:
+ *
+ *      ratelimit::error(logLimit, "Failed to read {GPIO}", "GPIO", lineMsg);
+ *
+ *  The limiter keeps the site, the format string has to be a literal.
+ */
+template <typename... Ts>
+struct error
+{
+    explicit error(
+        Limiter& limiter, const char* msg, Ts&&... ts,
+        const std::source_location& s = std::source_location::current())
+    {
+        if (limiter.allow(msg))
+        {
+            lg2::error<Ts...>(msg, std::forward<Ts>(ts)..., s);
+        }
+    }
+};
+
+template <typename... Ts>
+explicit error(Limiter&, const char*, Ts&&...) -> error<Ts...>;
+
+/** @brief Rate limited lg2::warning(), see error */
+template <typename... Ts>
+struct warning
+{
+    explicit warning(
+        Limiter& limiter, const char* msg, Ts&&... ts,
+        const std::source_location& s = std::source_location::current())
+    {
+        if (limiter.allow(msg))
+        {
+            lg2::warning<Ts...>(msg, std::forward<Ts>(ts)..., s);
+        }
+    }
+};
+
+template <typename... Ts>
+explicit warning(Limiter&, const char*, Ts&&...) -> warning<Ts...>;
+
+/** @brief Rate limited lg2::info(), see error */
+template <typename... Ts>
+struct info
+{
+    explicit info(
+        Limiter& limiter, const char* msg, Ts&&... ts,
+        const std::source_location& s = std::source_location::current())
+    {
+        if (limiter.allow(msg))
+        {
+            lg2::info<Ts...>(msg, std::forward<Ts>(ts)..., s);
+        }
+    }
+};
+
+template <typename... Ts>
+explicit info(Limiter&, const char*, Ts&&...) -> info<Ts...>;
+
+} // namespace ratelimit
+} // namespace gpio
+} // namespace phosphor
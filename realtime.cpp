@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "realtime.hpp"
+
+#include <sched.h>
+#include <sys/mman.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace realtime
+{
+
+/* Stack touched up front so handlers never take a page fault on it */
+constexpr size_t prefaultStackSize = 256 * 1024;
+
+/* Interval between two latency summaries */
+constexpr uint64_t reportIntervalNs = 60ULL * 1000 * 1000 * 1000;
+
+namespace
+{
+
+bool active = false;
+
+/** @brief Scheduling latency collected since the last summary */
+struct LatencyStats
+{
+    uint64_t count = 0;
+    uint64_t sumNs = 0;
+    uint64_t minNs = std::numeric_limits<uint64_t>::max();
+    uint64_t maxNs = 0;
+    uint64_t lastReportNs = 0;
+
+    /** @brief Worst latency seen since realtime mode was enabled */
+    uint64_t worstNs = 0;
+};
+
+LatencyStats stats;
+
+uint64_t toNs(const timespec& ts)
+{
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL +
+           static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void prefaultStack()
+{
+    std::array<unsigned char, prefaultStackSize> stack;
+
+    /* explicit_bzero() is never optimized away, so every page is touched */
+    explicit_bzero(stack.data(), stack.size());
+}
+
+} // namespace
+
+int enable(const Config& config)
+{
+    if (config.cpu < -1 || config.cpu > maxCpu)
+    {
+        lg2::error("CPU {CPU} is not between -1 and {MAX}", "CPU",
+                   config.cpu, "MAX", maxCpu);
+        return -EINVAL;
+    }
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) < 0)
+    {
+        auto err = errno;
+        lg2::error("Failed to lock memory: {ERROR}", "ERROR", strerror(err));
+        return -err;
+    }
+
+    prefaultStack();
+
+    if (config.cpu >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(config.cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) < 0)
+        {
+            auto err = errno;
+            lg2::error("Failed to pin to CPU {CPU}: {ERROR}", "CPU",
+                       config.cpu, "ERROR", strerror(err));
+            return -err;
+        }
+    }
+
+    sched_param param{};
+    param.sched_priority = config.priority;
+    if (sched_setscheduler(0, SCHED_FIFO, &param) < 0)
+    {
+        auto err = errno;
+        lg2::error("Failed to set SCHED_FIFO priority {PRIORITY}: {ERROR}",
+                   "PRIORITY", config.priority, "ERROR", strerror(err));
+        return -err;
+    }
+
+    active = true;
+
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    stats.lastReportNs = toNs(now);
+
+    lg2::info("Realtime mode enabled, priority: {PRIORITY}, CPU: {CPU}",
+              "PRIORITY", config.priority, "CPU", config.cpu);
+
+    return 0;
+}
+
+bool enabled()
+{
+    return active;
+}
+
+void recordLatency(clockid_t clock, const timespec& eventTs)
+{
+    if (!active)
+    {
+        return;
+    }
+
+    timespec now{};
+    clock_gettime(clock, &now);
+
+    auto nowNs = toNs(now);
+    auto eventNs = toNs(eventTs);
+
+    /* Wall clock steps can put the event in the future, skip those */
+    if (eventNs > nowNs)
+    {
+        return;
+    }
+
+    auto latencyNs = nowNs - eventNs;
+
+    stats.count++;
+    stats.sumNs += latencyNs;
+    stats.minNs = std::min(stats.minNs, latencyNs);
+    stats.maxNs = std::max(stats.maxNs, latencyNs);
+    stats.worstNs = std::max(stats.worstNs, latencyNs);
+
+    if (clock != CLOCK_MONOTONIC)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        nowNs = toNs(now);
+    }
+
+    if (nowNs - stats.lastReportNs < reportIntervalNs)
+    {
+        return;
+    }
+
+    lg2::info(
+        "Scheduling latency over {COUNT} events: min {MIN} us, avg {AVG} us, max {MAX} us, worst {WORST} us",
+        "COUNT", stats.count, "MIN", stats.minNs / 1000, "AVG",
+        stats.sumNs / stats.count / 1000, "MAX", stats.maxNs / 1000, "WORST",
+        stats.worstNs / 1000);
+
+    auto worstNs = stats.worstNs;
+    stats = LatencyStats{};
+    stats.worstNs = worstNs;
+    stats.lastReportNs = nowNs;
+}
+
+} // namespace realtime
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <sched.h>
+#include <time.h>
+
+#include <cstdint>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace realtime
+{
+
+/** @brief Default SCHED_FIFO priority used in realtime mode */
+constexpr int defaultPriority = 50;
+
+/** @brief Highest CPU the event loop thread can be pinned to */
+constexpr int maxCpu = CPU_SETSIZE - 1;
+
+/** @brief Realtime execution settings */
+struct Config
+{
+    /** @brief SCHED_FIFO priority, 1 (lowest) to 99 (highest) */
+    int priority = defaultPriority;
+
+    /** @brief CPU to pin the event loop thread to, -1 to leave unpinned */
+    int cpu = -1;
+};
+
+/** @brief Switches the calling thread to realtime execution.
+ *
+ *  Locks current and future memory, prefaults the stack, sets the
+ *  SCHED_FIFO priority and optionally pins the thread to a CPU. The
+ *  daemons read GPIO events on their only thread, so this is called from
+ *  main() before the event loop starts.
+ *
+ *  Scheduling latency is only recorded once this succeeded.
+ *
+ *  @param[in] config - realtime settings
+ *
+ *  @return 0 on success and negative errno otherwise
+ */
+int enable(const Config& config);
+
+/** @brief Returns whether realtime mode is active */
+bool enabled();
+
+/** @brief Records the delay between a kernel event timestamp and now.
+ *
+ *  No-op unless realtime mode is active. A summary of the collected
+ *  latencies is logged periodically.
+ *
+ *  @param[in] clock   - clock the kernel used for the timestamp
+ *  @param[in] eventTs - kernel timestamp of the event
+ */
+void recordLatency(clockid_t clock, const timespec& eventTs);
+
+} // namespace realtime
+} // namespace gpio
+} // namespace phosphor
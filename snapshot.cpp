@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "snapshot.hpp"
+
+namespace phosphor
+{
+namespace gpio
+{
+
+std::shared_ptr<sdbusplus::asio::dbus_interface>
+    addSnapshot(sdbusplus::asio::object_server& server, SnapshotSource source)
+{
+    auto iface = server.add_interface(snapshotPath, snapshotInterface);
+    iface->register_method("GetLines", [source = std::move(source)]() {
+        return source();
+    });
+    iface->initialize();
+
+    return iface;
+}
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <sdbusplus/asio/object_server.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @brief Object path of the snapshot of all lines */
+constexpr auto snapshotPath = "/xyz/openbmc_project/gpio";
+
+/** @brief Interface with the snapshot method */
+constexpr auto snapshotInterface = "xyz.openbmc_project.GPIO.Snapshot";
+
+/** @brief Name, value (-1 while unknown) and CLOCK_MONOTONIC time of the
+ *         last change in microseconds (0 before the first one) of a line
+ */
+using LineSnapshot = std::tuple<std::string, int32_t, uint64_t>;
+
+/** @brief Returns the cached state of all configured lines */
+using SnapshotSource = std::function<std::vector<LineSnapshot>()>;
+
+/** @brief Adds the GetLines method returning the state of all lines in one
+ *         call. The source only reads cached state, it must not touch the
+ *         hardware.
+ *
+ *  @param[in] server - object server hosting the method
+ *  @param[in] source - returns the state of the lines
+ *
+ *  @return the interface, the method is removed with it
+ */
+std::shared_ptr<sdbusplus::asio::dbus_interface>
+    addSnapshot(sdbusplus::asio::object_server& server, SnapshotSource source);
+
+} // namespace gpio
+} // namespace phosphor
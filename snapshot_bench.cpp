@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "line_object.hpp"
+#include "snapshot.hpp"
+
+#include <CLI/CLI.hpp>
+#include <sdbusplus/bus.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <variant>
+#include <vector>
+
+using namespace phosphor::gpio;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Reads the state of all lines with one GetLines call
+ *
+ * @param[in] bus     - bus to call on
+ * @param[in] service - daemon hosting the snapshot
+ *
+ * @return The state of the lines
+ */
+static std::vector<LineSnapshot> getLines(sdbusplus::bus_t& bus,
+                                          const std::string& service)
+{
+    auto method = bus.new_method_call(service.c_str(), snapshotPath,
+                                      snapshotInterface, "GetLines");
+    auto reply = bus.call(method);
+    return reply.unpack<std::vector<LineSnapshot>>();
+}
+
+/**
+ * Reads the value of a line from its line object
+ *
+ * @param[in] bus     - bus to call on
+ * @param[in] service - daemon hosting the line object
+ * @param[in] name    - name of the line
+ *
+ * @return The line value
+ */
+static int32_t getValue(sdbusplus::bus_t& bus, const std::string& service,
+                        const std::string& name)
+{
+    auto path = (sdbusplus::object_path(linePath) / name).str;
+    auto method = bus.new_method_call(service.c_str(), path.c_str(),
+                                      "org.freedesktop.DBus.Properties", "Get");
+    method.append(lineInterface, "Value");
+    auto reply = bus.call(method);
+    return std::get<int32_t>(reply.unpack<std::variant<int32_t>>());
+}
+
+/**
+ * Prints the mean time of a round
+ *
+ * @param[in] label   - what a round did
+ * @param[in] elapsed - time of all rounds
+ * @param[in] rounds  - number of rounds
+ */
+static void printMean(const std::string& label, Clock::duration elapsed,
+                      unsigned rounds)
+{
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed)
+                  .count();
+    std::cout << label << ": " << us / rounds << " us per round\n";
+}
+
+int main(int argc, char** argv)
+{
+    CLI::App app{"Compare reading all GPIO lines in one call with one call "
+                 "per line"};
+
+    std::string service = "xyz.openbmc_project.GPIO.Monitor";
+    unsigned rounds = 100;
+
+    app.add_option("-s,--service", service,
+                   "Daemon to query, phosphor-multi-gpio-monitor by default");
+    app.add_option("-n,--rounds", rounds, "Reads of all lines to average")
+        ->check(CLI::PositiveNumber);
+
+    try
+    {
+        app.parse(argc, argv);
+    }
+    catch (const CLI::Error& e)
+    {
+        return app.exit(e);
+    }
+
+    auto bus = sdbusplus::bus::new_default();
+    std::vector<LineSnapshot> lines;
+
+    try
+    {
+        auto start = Clock::now();
+        for (unsigned i = 0; i < rounds; i++)
+        {
+            lines = getLines(bus, service);
+        }
+        std::cout << lines.size() << " lines\n";
+        printMean("GetLines", Clock::now() - start, rounds);
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        std::cerr << "Failed to get the lines of " << service << ": "
+                  << e.what() << "\n";
+        return -1;
+    }
+
+    /* Only phosphor-multi-gpio-monitor has an object per line */
+    try
+    {
+        auto start = Clock::now();
+        for (unsigned i = 0; i < rounds; i++)
+        {
+            for (const auto& line : lines)
+            {
+                getValue(bus, service, std::get<0>(line));
+            }
+        }
+        printMean("Get per line", Clock::now() - start, rounds);
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        std::cerr << "No line objects on " << service << ": " << e.what()
+                  << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "startup.hpp"
+
+#include <systemd/sd-daemon.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace startup
+{
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+
+/** @brief Time the process started, close enough for a boot breakdown */
+const Clock::time_point processStart = Clock::now();
+
+bool started = false;
+
+/** @brief Innermost phase being timed */
+Phase* current = nullptr;
+
+/** @brief Accumulated time per phase, in the order first entered */
+std::vector<std::pair<const char*, Clock::duration>> phases;
+
+uint64_t toUs(Clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+        .count();
+}
+
+} // namespace
+
+Phase::Phase(const char* name) :
+    name(name), start(Clock::now()), parent(current)
+{
+    current = this;
+}
+
+Phase::~Phase()
+{
+    end();
+}
+
+void Phase::end()
+{
+    if (ended)
+    {
+        return;
+    }
+    ended = true;
+
+    current = parent;
+    if (started)
+    {
+        return;
+    }
+
+    auto elapsed = Clock::now() - start;
+    if (parent)
+    {
+        parent->nested += elapsed;
+    }
+
+    auto it = std::find_if(phases.begin(), phases.end(), [this](auto& p) {
+        return std::strcmp(p.first, name) == 0;
+    });
+    if (it == phases.end())
+    {
+        phases.emplace_back(name, Clock::duration{});
+        it = std::prev(phases.end());
+    }
+    it->second += elapsed - nested;
+}
+
+void ready()
+{
+    if (started)
+    {
+        return;
+    }
+    started = true;
+
+    auto total = Clock::now() - processStart;
+
+    std::string breakdown;
+    for (const auto& [name, duration] : phases)
+    {
+        if (!breakdown.empty())
+        {
+            breakdown += ", ";
+        }
+        breakdown += std::string(name) + " " + std::to_string(toUs(duration)) +
+                     " us";
+    }
+
+    lg2::info("Started in {TOTAL_US} us: {PHASES}", "TOTAL_US", toUs(total),
+              "PHASES", breakdown);
+
+    sd_notifyf(0, "READY=1\nSTATUS=Started in %llu us",
+               static_cast<unsigned long long>(toUs(total)));
+}
+
+} // namespace startup
+} // namespace gpio
+} // namespace phosphor
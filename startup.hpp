@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <chrono>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace startup
+{
+
+/** @class Phase
+ *  @brief Adds the time of a scope to a named startup phase.
+ *
+ *  A phase may be entered several times, for example once per line, and
+ *  its times add up. Time spent in a nested phase only counts for the
+ *  nested one. Phases entered after ready() are not recorded, so handlers
+ *  shared with the event loop can be timed unconditionally.
+ */
+class Phase
+{
+  public:
+    Phase() = delete;
+    Phase(const Phase&) = delete;
+    Phase& operator=(const Phase&) = delete;
+    Phase(Phase&&) = delete;
+    Phase& operator=(Phase&&) = delete;
+
+    /** @brief Starts timing a phase
+     *
+     *  @param[in] name - phase name, a string literal
+     */
+    explicit Phase(const char* name);
+    ~Phase();
+
+    /** @brief Ends the phase before the end of its scope */
+    void end();
+
+  private:
+    const char* name;
+    std::chrono::steady_clock::time_point start;
+
+    /** @brief Enclosing phase, its time excludes this one */
+    Phase* parent;
+
+    /** @brief Time of the nested phases */
+    std::chrono::steady_clock::duration nested{};
+
+    bool ended = false;
+};
+
+/** @brief Reports the daemon as started.
+ *
+ *  Logs the time since the process started with the breakdown per phase
+ *  and sends READY=1 to systemd. Called once every configured line is
+ *  armed and its initial state was handled.
+ */
+void ready();
+
+} // namespace startup
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "storm.hpp"
+
+namespace phosphor
+{
+namespace gpio
+{
+
+bool StormDetector::edges(size_t count, Clock::time_point now)
+{
+    if (config.rate == 0 || inStorm)
+    {
+        return false;
+    }
+
+    if (now - windowStart >= window)
+    {
+        windowStart = now;
+        windowEdges = 0;
+    }
+
+    windowEdges += count;
+    if (windowEdges <= config.rate)
+    {
+        return false;
+    }
+
+    inStorm = true;
+    stormCount++;
+    lastChange = now;
+    return true;
+}
+
+bool StormDetector::sample(bool changed, Clock::time_point now)
+{
+    if (!inStorm)
+    {
+        return false;
+    }
+
+    if (changed)
+    {
+        lastChange = now;
+        return false;
+    }
+
+    if (now - lastChange < config.quietTime)
+    {
+        return false;
+    }
+
+    /* Edges counted before the storm do not count against the next one */
+    inStorm = false;
+    windowStart = now;
+    windowEdges = 0;
+    return true;
+}
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @class StormDetector
+ *  @brief Decides when a line switches between edge events and polling.
+ *
+ *  A line whose edges come in faster than the configured rate costs an
+ *  interrupt and a wakeup per edge. Such a line is better sampled at a
+ *  bounded rate until it has been quiet for a while, after which edge
+ *  events are requested again. The detector only takes the decisions, the
+ *  monitor of the line does the switching.
+ */
+class StormDetector
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Config
+    {
+        /** @brief Edges per second starting a storm, 0 disables detection */
+        unsigned rate = 0;
+        /** @brief Interval of the samples during a storm */
+        std::chrono::milliseconds pollInterval{20};
+        /** @brief Time without change ending a storm */
+        std::chrono::milliseconds quietTime{5000};
+    };
+
+    StormDetector() = delete;
+    ~StormDetector() = default;
+    StormDetector(const StormDetector&) = delete;
+    StormDetector& operator=(const StormDetector&) = delete;
+    StormDetector(StormDetector&&) = delete;
+    StormDetector& operator=(StormDetector&&) = delete;
+
+    /** @brief Constructs StormDetector object.
+     *
+     *  @param[in] config - storm rate and polling parameters
+     */
+    explicit StormDetector(const Config& config) : config(config) {}
+
+    /** @brief Counts edges read from the line
+     *
+     *  @param[in] count - number of edges read
+     *  @param[in] now   - time of the read
+     *
+     *  @return true if the line started storming and has to be polled
+     */
+    bool edges(size_t count, Clock::time_point now);
+
+    /** @brief Counts a sample taken during a storm
+     *
+     *  @param[in] changed - whether the line changed since the last sample
+     *  @param[in] now     - time of the sample
+     *
+     *  @return true if the line is quiet and edge events can be requested
+     *          again
+     */
+    bool sample(bool changed, Clock::time_point now);
+
+    /** @brief Returns whether the line is polled because of a storm */
+    bool storming() const
+    {
+        return inStorm;
+    }
+
+    /** @brief Returns the number of storms detected */
+    uint64_t storms() const
+    {
+        return stormCount;
+    }
+
+    /** @brief Returns the polling parameters */
+    const Config& settings() const
+    {
+        return config;
+    }
+
+  private:
+    /** @brief Length of the window the edges are counted in */
+    static constexpr auto window = std::chrono::seconds(1);
+
+    const Config config;
+
+    bool inStorm = false;
+    uint64_t stormCount = 0;
+
+    /** @brief Start of the current window and the edges counted in it */
+    Clock::time_point windowStart;
+    uint64_t windowEdges = 0;
+
+    /** @brief Time of the last change seen during a storm */
+    Clock::time_point lastChange;
+};
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "action_queue.hpp"
+
+#include "line_profile.hpp"
+
+#include <boost/asio/io_context.hpp>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+
+class ActionQueueTest : public ::testing::Test
+{
+  public:
+    boost::asio::io_context io;
+
+    // Actions run, in order, and actions dropped or merged
+    std::vector<std::string> runs;
+    std::vector<std::string> drops;
+
+    ActionQueue::Action action(const std::string& name)
+    {
+        return [this, name](bool run) {
+            (run ? runs : drops).push_back(name);
+        };
+    }
+
+    void fill(ActionQueue& queue)
+    {
+        queue.push("A", profile::addLine("A"), "a.target", action("A1"));
+        queue.push("B", profile::addLine("B"), "b.target", action("B1"));
+    }
+};
+
+/** @brief Makes sure that actions run in order from the event loop */
+TEST_F(ActionQueueTest, runsInOrder)
+{
+    ActionQueue queue(io, {4, ActionQueue::Overflow::dropOldest});
+    fill(queue);
+
+    EXPECT_TRUE(runs.empty());
+    EXPECT_EQ(queue.depth(), 2U);
+
+    io.run();
+    EXPECT_EQ(runs, (std::vector<std::string>{"A1", "B1"}));
+    EXPECT_EQ(queue.depth(), 0U);
+    EXPECT_EQ(queue.highWater(), 2U);
+}
+
+/** @brief Makes sure that a full queue drops its oldest action */
+TEST_F(ActionQueueTest, dropOldest)
+{
+    ActionQueue queue(io, {2, ActionQueue::Overflow::dropOldest});
+    fill(queue);
+    queue.push("A", profile::addLine("A"), "a.target", action("A2"));
+
+    io.run();
+    EXPECT_EQ(runs, (std::vector<std::string>{"B1", "A2"}));
+    EXPECT_EQ(drops, (std::vector<std::string>{"A1"}));
+    EXPECT_EQ(queue.dropped(), 1U);
+}
+
+/** @brief Makes sure that an action of a queued target is merged into it */
+TEST_F(ActionQueueTest, mergeTarget)
+{
+    ActionQueue queue(io, {2, ActionQueue::Overflow::mergeTarget});
+    fill(queue);
+    queue.push("C", profile::addLine("C"), "b.target", action("C1"));
+    queue.push("C", profile::addLine("C"), "c.target", action("C2"));
+
+    io.run();
+    EXPECT_EQ(runs, (std::vector<std::string>{"B1", "C2"}));
+    EXPECT_EQ(drops, (std::vector<std::string>{"C1", "A1"}));
+    EXPECT_EQ(queue.merged(), 1U);
+    EXPECT_EQ(queue.dropped(), 1U);
+}
+
+/** @brief Makes sure that the latest action of a line replaces its queued
+ *         one in place
+ */
+TEST_F(ActionQueueTest, latestPerLine)
+{
+    ActionQueue queue(io, {2, ActionQueue::Overflow::latestPerLine});
+    fill(queue);
+    queue.push("A", profile::addLine("A"), "a.target", action("A2"));
+
+    io.run();
+    EXPECT_EQ(runs, (std::vector<std::string>{"A2", "B1"}));
+    EXPECT_EQ(drops, (std::vector<std::string>{"A1"}));
+    EXPECT_EQ(queue.merged(), 1U);
+    EXPECT_EQ(queue.dropped(), 0U);
+}
+
+/** @brief Makes sure that a replacing action supersedes the queued one of
+ *         its target whatever the policy, even when the queue is not full
+ */
+TEST_F(ActionQueueTest, replaceTarget)
+{
+    ActionQueue queue(io, {4, ActionQueue::Overflow::mergeTarget});
+    fill(queue);
+    queue.replace("C", profile::addLine("C"), "a.target", action("C1"));
+    queue.replace("C", profile::addLine("C"), "c.target", action("C2"));
+
+    io.run();
+    EXPECT_EQ(runs, (std::vector<std::string>{"C1", "B1", "C2"}));
+    EXPECT_EQ(drops, (std::vector<std::string>{"A1"}));
+    EXPECT_EQ(queue.merged(), 1U);
+    EXPECT_EQ(queue.dropped(), 0U);
+}
+
+/** @brief Makes sure that a queue without capacity runs actions directly */
+TEST_F(ActionQueueTest, unbuffered)
+{
+    ActionQueue queue(io, {0, ActionQueue::Overflow::dropOldest});
+    fill(queue);
+
+    EXPECT_EQ(runs, (std::vector<std::string>{"A1", "B1"}));
+}
+
+/** @brief Makes sure that a queued run is charged to the profile of its line
+ */
+TEST_F(ActionQueueTest, chargesLine)
+{
+    ActionQueue queue(io, {4, ActionQueue::Overflow::dropOldest});
+    auto id = profile::addLine("D");
+    queue.push("D", id, "d.target", action("D1"));
+
+    EXPECT_EQ(profile::stats(id).events, 0U);
+    io.run();
+    EXPECT_EQ(runs, (std::vector<std::string>{"D1"}));
+    EXPECT_EQ(profile::stats(id).events, 1U);
+}
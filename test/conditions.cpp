@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "conditions.hpp"
+
+#include <boost/asio/io_context.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+using namespace std::chrono_literals;
+
+class ConditionTest : public ::testing::Test
+{
+  public:
+    boost::asio::io_context io;
+    ConditionEngine engine{io};
+
+    size_t powerGood = engine.addLine("PowerGood");
+    size_t cpuPresent = engine.addLine("CpuPresent");
+    size_t riserA = engine.addLine("RiserA");
+    size_t riserB = engine.addLine("RiserB");
+
+    // States reported to the handler, in order
+    std::vector<bool> changes;
+
+    ConditionEngine::Handler record()
+    {
+        return [this](bool state) { changes.push_back(state); };
+    }
+};
+
+/** @brief Makes sure that a condition follows its expression
+ */
+TEST_F(ConditionTest, followsExpression)
+{
+    engine.addCondition("Riser", "RiserA && RiserB", 0ms, {}, record());
+    engine.start();
+
+    engine.setLine(riserA, true);
+    EXPECT_TRUE(changes.empty());
+
+    engine.setLine(riserB, true);
+    ASSERT_EQ(1, changes.size());
+    EXPECT_TRUE(changes.back());
+    EXPECT_TRUE(engine.state("Riser"));
+
+    engine.setLine(riserA, false);
+    ASSERT_EQ(2, changes.size());
+    EXPECT_FALSE(changes.back());
+}
+
+/** @brief Makes sure that precedence and parentheses are honored
+ */
+TEST_F(ConditionTest, precedence)
+{
+    engine.addCondition("A", "!PowerGood && CpuPresent || RiserA", 0ms, {},
+                        record());
+    engine.addCondition("B", "!(PowerGood || CpuPresent) && !RiserA", 0ms,
+                        {}, record());
+    engine.start();
+
+    // All lines low
+    EXPECT_FALSE(engine.state("A"));
+    EXPECT_TRUE(engine.state("B"));
+
+    engine.setLine(cpuPresent, true);
+    EXPECT_TRUE(engine.state("A"));
+    EXPECT_FALSE(engine.state("B"));
+
+    engine.setLine(powerGood, true);
+    EXPECT_FALSE(engine.state("A"));
+
+    engine.setLine(riserA, true);
+    EXPECT_TRUE(engine.state("A"));
+}
+
+/** @brief Makes sure that only trigger lines run the handler
+ */
+TEST_F(ConditionTest, triggerLines)
+{
+    engine.setLine(powerGood, true);
+    engine.setLine(cpuPresent, true);
+    engine.addCondition("Recovery", "!PowerGood && !CpuPresent", 0ms,
+                        {"PowerGood"}, record());
+    engine.start();
+
+    // CPU_PRESENT falls, then PS_PWROK falls
+    engine.setLine(cpuPresent, false);
+    EXPECT_TRUE(changes.empty());
+    engine.setLine(powerGood, false);
+    ASSERT_EQ(1, changes.size());
+    EXPECT_TRUE(changes.back());
+
+    // CPU_PRESENT comes back, the state follows without running the handler
+    engine.setLine(cpuPresent, true);
+    EXPECT_EQ(1, changes.size());
+    EXPECT_FALSE(engine.state("Recovery"));
+}
+
+/** @brief Makes sure that a hold time filters short changes
+ */
+TEST_F(ConditionTest, holdTime)
+{
+    engine.addCondition("Riser", "RiserA", 50ms, {}, record());
+    engine.start();
+
+    // Glitch shorter than the hold time
+    engine.setLine(riserA, true);
+    io.run_for(10ms);
+    engine.setLine(riserA, false);
+    io.restart();
+    io.run_for(100ms);
+    EXPECT_TRUE(changes.empty());
+    EXPECT_FALSE(engine.state("Riser"));
+
+    // Change held long enough
+    engine.setLine(riserA, true);
+    io.restart();
+    io.run_for(100ms);
+    ASSERT_EQ(1, changes.size());
+    EXPECT_TRUE(changes.back());
+}
+
+/** @brief Makes sure that invalid expressions are rejected
+ */
+TEST_F(ConditionTest, invalidExpression)
+{
+    EXPECT_THROW(engine.addCondition("X", "RiserA &&", 0ms, {}, record()),
+                 std::invalid_argument);
+    EXPECT_THROW(engine.addCondition("X", "(RiserA", 0ms, {}, record()),
+                 std::invalid_argument);
+    EXPECT_THROW(engine.addCondition("X", "Unknown", 0ms, {}, record()),
+                 std::invalid_argument);
+    EXPECT_THROW(engine.addCondition("X", "RiserA RiserB", 0ms, {}, record()),
+                 std::invalid_argument);
+    EXPECT_THROW(engine.addCondition("X", "RiserA", 0ms, {"Unknown"}, record()),
+                 std::invalid_argument);
+}
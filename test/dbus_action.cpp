@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "dbus_action.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+
+/** @brief Makes sure that values take the JSON type without a signature */
+TEST(DBusActionTest, jsonTypes)
+{
+    EXPECT_EQ(DBusAction::Arg(std::string("on")),
+              DBusAction::parseArg("on", 0));
+    EXPECT_EQ(DBusAction::Arg(true), DBusAction::parseArg(true, 0));
+    EXPECT_EQ(DBusAction::Arg(int32_t(-3)), DBusAction::parseArg(-3, 0));
+    EXPECT_EQ(DBusAction::Arg(1.5), DBusAction::parseArg(1.5, 0));
+}
+
+/** @brief Makes sure that values are converted to their signature and
+ *         rejected when they do not fit it
+ */
+TEST(DBusActionTest, signature)
+{
+    EXPECT_EQ(DBusAction::Arg(uint8_t(255)), DBusAction::parseArg(255, 'y'));
+    EXPECT_FALSE(DBusAction::parseArg(256, 'y'));
+    EXPECT_FALSE(DBusAction::parseArg(-1, 'u'));
+    EXPECT_EQ(DBusAction::Arg(int64_t(-1)), DBusAction::parseArg(-1, 'x'));
+    EXPECT_EQ(DBusAction::Arg(uint64_t(1) << 40),
+              DBusAction::parseArg(uint64_t(1) << 40, 't'));
+    EXPECT_EQ(DBusAction::Arg(2.0), DBusAction::parseArg(2, 'd'));
+    EXPECT_EQ(DBusAction::Arg(sdbusplus::object_path("/xyz")),
+              DBusAction::parseArg("/xyz", 'o'));
+    EXPECT_FALSE(DBusAction::parseArg("1", 'i'));
+    EXPECT_FALSE(DBusAction::parseArg(1, 'b'));
+    EXPECT_FALSE(DBusAction::parseArg(1, 'a'));
+}
+
+/** @brief Makes sure that invalid actions are rejected at config load */
+TEST(DBusActionTest, invalid)
+{
+    auto property = R"({
+        "Service": "xyz.openbmc_project.State.Host",
+        "Path": "/xyz/openbmc_project/state/host0",
+        "Interface": "xyz.openbmc_project.State.Host",
+        "Property": "RequestedHostTransition",
+        "Value": "xyz.openbmc_project.State.Host.Transition.On"
+    })"_json;
+    EXPECT_NO_THROW(DBusAction{property});
+
+    auto noValue = property;
+    noValue.erase("Value");
+    EXPECT_THROW(DBusAction{noValue}, std::invalid_argument);
+
+    auto noService = property;
+    noService.erase("Service");
+    EXPECT_THROW(DBusAction{noService}, std::invalid_argument);
+
+    auto method = R"({
+        "Service": "org.freedesktop.systemd1",
+        "Path": "/org/freedesktop/systemd1",
+        "Interface": "org.freedesktop.systemd1.Manager",
+        "Method": "KillUnit",
+        "Args": ["foo.service", "all", 15],
+        "Signature": "ssi"
+    })"_json;
+    EXPECT_NO_THROW(DBusAction{method});
+
+    method["Signature"] = "ss";
+    EXPECT_THROW(DBusAction{method}, std::invalid_argument);
+
+    method["Signature"] = "sss";
+    EXPECT_THROW(DBusAction{method}, std::invalid_argument);
+
+    /* Fields of the wrong type are config errors, not json errors */
+    method["Signature"] = 3;
+    EXPECT_THROW(DBusAction{method}, std::invalid_argument);
+
+    method.erase("Signature");
+    method["Args"] = "foo.service";
+    EXPECT_THROW(DBusAction{method}, std::invalid_argument);
+
+    auto badService = property;
+    badService["Service"] = 1;
+    EXPECT_THROW(DBusAction{badService}, std::invalid_argument);
+
+    EXPECT_THROW(DBusAction{R"(["Service"])"_json}, std::invalid_argument);
+}
+
+/** @brief Makes sure that invalid D-Bus names are rejected at config load
+ *         instead of failing the call of every edge
+ */
+TEST(DBusActionTest, invalidNames)
+{
+    auto method = R"({
+        "Service": "org.freedesktop.systemd1",
+        "Path": "/org/freedesktop/systemd1",
+        "Interface": "org.freedesktop.systemd1.Manager",
+        "Method": "Reload"
+    })"_json;
+    EXPECT_NO_THROW(DBusAction{method});
+
+    auto badPath = method;
+    badPath["Path"] = "/org/freedesktop/systemd1/";
+    EXPECT_THROW(DBusAction{badPath}, std::invalid_argument);
+
+    auto badInterface = method;
+    badInterface["Interface"] = "systemd1";
+    EXPECT_THROW(DBusAction{badInterface}, std::invalid_argument);
+
+    auto badService = method;
+    badService["Service"] = "org..freedesktop";
+    EXPECT_THROW(DBusAction{badService}, std::invalid_argument);
+
+    auto badMethod = method;
+    badMethod["Method"] = "Re-load";
+    EXPECT_THROW(DBusAction{badMethod}, std::invalid_argument);
+
+    auto badProperty = R"({
+        "Service": "xyz.openbmc_project.State.Host",
+        "Path": "/xyz/openbmc_project/state/host0",
+        "Interface": "xyz.openbmc_project.State.Host",
+        "Property": "Requested.Transition",
+        "Value": "On"
+    })"_json;
+    EXPECT_THROW(DBusAction{badProperty}, std::invalid_argument);
+}
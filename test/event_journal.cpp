@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "event_journal.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+
+namespace
+{
+
+std::string journalPath()
+{
+    char dir[] = "/tmp/event_journal_testXXXXXX";
+    EXPECT_NE(mkdtemp(dir), nullptr);
+    return std::string(dir) + "/test.journal";
+}
+
+/** @brief Maps a journal file read only, like phosphor-gpio-journal */
+class Mapping
+{
+  public:
+    explicit Mapping(const std::string& path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return;
+        }
+
+        struct stat st{};
+        if (fstat(fd, &st) == 0)
+        {
+            size = st.st_size;
+            map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+    }
+
+    ~Mapping()
+    {
+        if (map != MAP_FAILED)
+        {
+            munmap(map, size);
+        }
+    }
+
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    const journal::Header* header() const
+    {
+        return map != MAP_FAILED ? static_cast<const journal::Header*>(map)
+                                 : nullptr;
+    }
+
+    const journal::Record& record(uint32_t slot) const
+    {
+        return reinterpret_cast<const journal::Record*>(header() + 1)[slot];
+    }
+
+    size_t size = 0;
+
+  private:
+    void* map = MAP_FAILED;
+};
+
+} // namespace
+
+TEST(EventJournal, recordNeedsOpen)
+{
+    auto line = journal::addLine("GPIO Line PS_PWROK");
+    EXPECT_FALSE(journal::record(line, journal::Edge::rising, {1, 0}, 1, 0));
+}
+
+TEST(EventJournal, openWritesHeader)
+{
+    /* Lines added before the journal is opened are written by open() */
+    auto before = journal::addLine("GPIO Line PS_PWROK");
+    auto path = journalPath();
+    ASSERT_EQ(journal::open(path, CLOCK_MONOTONIC, 8), 0);
+    auto after = journal::addLine("GPIO Line POWER_BUTTON");
+    EXPECT_EQ(journal::addLine("GPIO Line PS_PWROK"), before);
+    EXPECT_EQ(journal::addLine("GPIO Line POWER_BUTTON"), after);
+    EXPECT_NE(before, after);
+
+    Mapping mapping(path);
+    const auto* header = mapping.header();
+    ASSERT_NE(header, nullptr);
+    EXPECT_EQ(mapping.size,
+              sizeof(journal::Header) + 8 * sizeof(journal::Record));
+    EXPECT_EQ(header->magic, journal::magic);
+    EXPECT_EQ(header->version, journal::version);
+    EXPECT_EQ(header->recordSize, sizeof(journal::Record));
+    EXPECT_EQ(header->capacity, 8U);
+    EXPECT_EQ(header->clockId, CLOCK_MONOTONIC);
+    EXPECT_EQ(header->head, 0U);
+    EXPECT_EQ(header->lineCount, 2U);
+    EXPECT_STREQ(header->lineNames[before], "GPIO Line PS_PWROK");
+    EXPECT_STREQ(header->lineNames[after], "GPIO Line POWER_BUTTON");
+
+    std::filesystem::remove_all(std::filesystem::path(path).parent_path());
+}
+
+TEST(EventJournal, recordsWrapAround)
+{
+    auto path = journalPath();
+    ASSERT_EQ(journal::open(path, CLOCK_MONOTONIC, 4), 0);
+    auto line = journal::addLine("GPIO Line PS_PWROK");
+
+    for (int i = 1; i <= 6; i++)
+    {
+        auto edge = i % 2 ? journal::Edge::rising : journal::Edge::falling;
+        EXPECT_TRUE(journal::record(line, edge, {i, 500}, 1, -i));
+    }
+
+    Mapping mapping(path);
+    const auto* header = mapping.header();
+    ASSERT_NE(header, nullptr);
+    EXPECT_EQ(header->head, 6U);
+
+    /* Sequence n is in slot (n - 1) % capacity, the oldest two were
+     * overwritten */
+    EXPECT_EQ(mapping.record(0).sequence, 5U);
+    EXPECT_EQ(mapping.record(1).sequence, 6U);
+    EXPECT_EQ(mapping.record(2).sequence, 3U);
+    EXPECT_EQ(mapping.record(3).sequence, 4U);
+
+    const auto& last = mapping.record(1);
+    EXPECT_EQ(last.lineId, line);
+    EXPECT_EQ(last.edge, journal::Edge::falling);
+    EXPECT_EQ(last.timestampNs, 6000000500U);
+    EXPECT_EQ(last.actions, 1U);
+    EXPECT_EQ(last.result, -6);
+
+    std::filesystem::remove_all(std::filesystem::path(path).parent_path());
+}
+
+TEST(EventJournal, reopenKeepsMappedJournal)
+{
+    auto path = journalPath();
+    ASSERT_EQ(journal::open(path, CLOCK_MONOTONIC, 4), 0);
+    auto line = journal::addLine("GPIO Line PS_PWROK");
+    EXPECT_TRUE(journal::record(line, journal::Edge::rising, {1, 0}, 1, 0));
+
+    /* A reader of the previous journal keeps its records */
+    Mapping previous(path);
+    ASSERT_EQ(journal::open(path, CLOCK_MONOTONIC, 4), 0);
+    ASSERT_NE(previous.header(), nullptr);
+    EXPECT_EQ(previous.header()->head, 1U);
+    EXPECT_EQ(previous.record(0).sequence, 1U);
+
+    Mapping current(path);
+    ASSERT_NE(current.header(), nullptr);
+    EXPECT_EQ(current.header()->head, 0U);
+    EXPECT_STREQ(current.header()->lineNames[line], "GPIO Line PS_PWROK");
+
+    /* Only the journal file is left in the directory */
+    auto dir = std::filesystem::path(path).parent_path();
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(dir),
+                            std::filesystem::directory_iterator()),
+              1);
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "exec_action.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <nlohmann/json.hpp>
+
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+
+/** @brief Makes sure that the exit status of the program is recorded and
+ *         that the environment reaches it
+ */
+TEST(ExecActionTest, status)
+{
+    boost::asio::io_context io;
+    auto obj = R"({
+        "Command": ["/bin/sh", "-c", "exit $STATUS"],
+        "Env": {"STATUS": "3"}
+    })"_json;
+    ExecAction action(io, obj, {{"STATUS", "0"}},
+                      ratelimit::get("exec status"));
+
+    action.run();
+    EXPECT_EQ(1, action.instances());
+    io.run();
+
+    EXPECT_EQ(0, action.instances());
+    EXPECT_EQ(1, action.stats().runs);
+    EXPECT_EQ(1, action.stats().failed);
+    EXPECT_EQ(3, action.stats().lastStatus);
+}
+
+/** @brief Makes sure that edges are skipped while MaxRunning instances run
+ */
+TEST(ExecActionTest, maxRunning)
+{
+    boost::asio::io_context io;
+    auto obj = R"({
+        "Command": ["/bin/sh", "-c", "sleep 0.1"],
+        "MaxRunning": 2
+    })"_json;
+    ExecAction action(io, obj, {}, ratelimit::get("exec max running"));
+
+    action.run();
+    action.run();
+    action.run();
+    EXPECT_EQ(2, action.instances());
+    io.run();
+
+    EXPECT_EQ(2, action.stats().runs);
+    EXPECT_EQ(0, action.stats().failed);
+    EXPECT_EQ(1, action.stats().skipped);
+    EXPECT_EQ(0, action.stats().lastStatus);
+    EXPECT_GE(action.stats().maxRuntime.count(), 100000);
+}
+
+/** @brief Makes sure that invalid commands are rejected at config load */
+TEST(ExecActionTest, invalid)
+{
+    boost::asio::io_context io;
+    auto& logLimit = ratelimit::get("exec invalid");
+
+    EXPECT_THROW(ExecAction(io, R"({})"_json, {}, logLimit),
+                 std::invalid_argument);
+    EXPECT_THROW(ExecAction(io, R"({"Command": []})"_json, {}, logLimit),
+                 std::invalid_argument);
+    EXPECT_THROW(ExecAction(io, R"({"Command": ["sh"]})"_json, {}, logLimit),
+                 std::invalid_argument);
+    EXPECT_THROW(ExecAction(io, R"({"Command": ["/nonexistent/program"]})"_json,
+                            {}, logLimit),
+                 std::invalid_argument);
+}
+
+/** @brief Makes sure that fields of the wrong type or sign are rejected
+ *         instead of throwing a json error or wrapping around
+ */
+TEST(ExecActionTest, invalidTypes)
+{
+    boost::asio::io_context io;
+    auto& logLimit = ratelimit::get("exec invalid types");
+
+    EXPECT_THROW(ExecAction(io, R"(["/bin/sh"])"_json, {}, logLimit),
+                 std::invalid_argument);
+    EXPECT_THROW(ExecAction(io, R"({"Command": "/bin/sh"})"_json, {},
+                            logLimit),
+                 std::invalid_argument);
+    EXPECT_THROW(ExecAction(io, R"({"Command": ["/bin/sh", 1]})"_json, {},
+                            logLimit),
+                 std::invalid_argument);
+    EXPECT_THROW(
+        ExecAction(io, R"({"Command": ["/bin/sh"], "MaxRunning": -1})"_json,
+                   {}, logLimit),
+        std::invalid_argument);
+    EXPECT_THROW(
+        ExecAction(io, R"({"Command": ["/bin/sh"], "MaxRunning": 0})"_json,
+                   {}, logLimit),
+        std::invalid_argument);
+    EXPECT_THROW(
+        ExecAction(io, R"({"Command": ["/bin/sh"], "MaxRunning": "2"})"_json,
+                   {}, logLimit),
+        std::invalid_argument);
+    EXPECT_THROW(
+        ExecAction(io, R"({"Command": ["/bin/sh"], "Env": ["A=1"]})"_json,
+                   {}, logLimit),
+        std::invalid_argument);
+    EXPECT_THROW(
+        ExecAction(io, R"({"Command": ["/bin/sh"], "Env": {"A": 1}})"_json,
+                   {}, logLimit),
+        std::invalid_argument);
+}
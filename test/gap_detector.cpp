@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "gap_detector.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+
+/** @brief Makes sure that two edges of the same polarity count a gap */
+TEST(GapDetectorTest, samePolarity)
+{
+    GapDetector detector;
+
+    EXPECT_EQ(detector.edge(true, 0), GapDetector::Edge::next);
+    EXPECT_EQ(detector.edge(false, 1), GapDetector::Edge::next);
+    EXPECT_EQ(detector.edge(true, 1), GapDetector::Edge::gap);
+    EXPECT_EQ(detector.edge(false, 0), GapDetector::Edge::gap);
+    EXPECT_EQ(detector.gaps(), 2);
+}
+
+/** @brief Makes sure that no gap is found before the value is known */
+TEST(GapDetectorTest, unknownValue)
+{
+    GapDetector detector;
+
+    EXPECT_EQ(detector.edge(true, -1), GapDetector::Edge::next);
+    EXPECT_EQ(detector.edge(false, -1), GapDetector::Edge::next);
+    EXPECT_FALSE(detector.value(true, -1));
+    EXPECT_EQ(detector.gaps(), 0);
+}
+
+/** @brief Makes sure that the value is read as soon as a full read is
+ *         drained, and not while events are still pending
+ */
+TEST(GapDetectorTest, readWhenDrained)
+{
+    GapDetector detector;
+
+    // A read that did not fill the buffer cannot have overflowed
+    EXPECT_FALSE(detector.read(false, false));
+
+    // A full read that drained the FIFO reads the value right away
+    EXPECT_TRUE(detector.read(true, false));
+
+    // Full reads with events pending wait for the last one
+    EXPECT_FALSE(detector.read(true, true));
+    EXPECT_FALSE(detector.read(true, true));
+    EXPECT_TRUE(detector.read(false, false));
+
+    // The wakeup limit can end the reads with events still pending, the
+    // next wakeup reads the value once they are drained
+    EXPECT_FALSE(detector.read(true, true));
+    EXPECT_TRUE(detector.read(false, false));
+    EXPECT_FALSE(detector.read(false, false));
+}
+
+/** @brief Makes sure that a value ahead of the events handles the dropped
+ *         edge once, even when the kernel reports it late
+ */
+TEST(GapDetectorTest, valueAheadOfEvents)
+{
+    GapDetector detector;
+
+    // The value matches the events, nothing was dropped
+    EXPECT_FALSE(detector.value(true, 1));
+    EXPECT_EQ(detector.gaps(), 0);
+
+    // The last rising edge was dropped
+    EXPECT_TRUE(detector.value(true, 0));
+    EXPECT_EQ(detector.gaps(), 1);
+
+    // The kernel reports it after all, it is skipped
+    EXPECT_EQ(detector.edge(true, 1), GapDetector::Edge::handled);
+    EXPECT_EQ(detector.edge(false, 1), GapDetector::Edge::next);
+    EXPECT_EQ(detector.edge(false, 0), GapDetector::Edge::gap);
+    EXPECT_EQ(detector.gaps(), 2);
+}
+
+/** @brief Makes sure that a reset forgets a late edge */
+TEST(GapDetectorTest, reset)
+{
+    GapDetector detector;
+
+    EXPECT_TRUE(detector.value(false, 1));
+    EXPECT_FALSE(detector.read(true, true));
+    detector.reset();
+
+    EXPECT_EQ(detector.edge(false, 0), GapDetector::Edge::gap);
+    EXPECT_FALSE(detector.read(false, false));
+    EXPECT_EQ(detector.gaps(), 2);
+}
@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "gesture.hpp"
+
+#include <boost/asio/io_context.hpp>
+
+#include <chrono>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+using namespace std::chrono_literals;
+
+class GestureTest : public ::testing::Test
+{
+  public:
+    boost::asio::io_context io;
+
+    // Gestures reported to the handler, in order
+    std::vector<Gesture> gestures;
+
+    GestureRecognizer::Handler record()
+    {
+        return [this](Gesture gesture) { gestures.push_back(gesture); };
+    }
+
+    // Kernel style timestamp of an edge at the given offset from now
+    static timespec at(std::chrono::milliseconds offset)
+    {
+        auto time = std::chrono::steady_clock::now().time_since_epoch() +
+                    offset;
+        auto sec = std::chrono::duration_cast<std::chrono::seconds>(time);
+        auto nsec =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(time - sec);
+        return {sec.count(), nsec.count()};
+    }
+
+    void run(std::chrono::milliseconds duration)
+    {
+        io.restart();
+        io.run_for(duration);
+    }
+};
+
+/** @brief Makes sure that a short press is reported on release without a
+ *         double press window
+ */
+TEST_F(GestureTest, shortPress)
+{
+    GestureRecognizer recognizer(io, 500ms, 0ms, true, record());
+
+    recognizer.edge(false, at(0ms));
+    recognizer.edge(true, at(20ms));
+    ASSERT_EQ(1, gestures.size());
+    EXPECT_EQ(Gesture::shortPress, gestures.back());
+}
+
+/** @brief Makes sure that a short press waits for the double press window
+ */
+TEST_F(GestureTest, shortPressAfterWindow)
+{
+    GestureRecognizer recognizer(io, 500ms, 50ms, true, record());
+
+    recognizer.edge(false, at(0ms));
+    recognizer.edge(true, at(10ms));
+    EXPECT_TRUE(gestures.empty());
+
+    run(100ms);
+    ASSERT_EQ(1, gestures.size());
+    EXPECT_EQ(Gesture::shortPress, gestures.back());
+}
+
+/** @brief Makes sure that two presses within the window are a double press
+ */
+TEST_F(GestureTest, doublePress)
+{
+    GestureRecognizer recognizer(io, 500ms, 200ms, false, record());
+
+    recognizer.edge(true, at(0ms));
+    recognizer.edge(false, at(10ms));
+    recognizer.edge(true, at(50ms));
+    recognizer.edge(false, at(60ms));
+    ASSERT_EQ(1, gestures.size());
+    EXPECT_EQ(Gesture::doublePress, gestures.back());
+
+    // No short press is left pending
+    run(300ms);
+    EXPECT_EQ(1, gestures.size());
+}
+
+/** @brief Makes sure that a long press is reported while still held
+ */
+TEST_F(GestureTest, longPressWhileHeld)
+{
+    GestureRecognizer recognizer(io, 50ms, 0ms, true, record());
+
+    recognizer.edge(false, at(0ms));
+    run(100ms);
+    ASSERT_EQ(1, gestures.size());
+    EXPECT_EQ(Gesture::longPress, gestures.back());
+
+    // The release does not report anything else
+    recognizer.edge(true, at(100ms));
+    EXPECT_EQ(1, gestures.size());
+}
+
+/** @brief Makes sure that a long second press cancels the double press
+ */
+TEST_F(GestureTest, longPressCancelsDouble)
+{
+    GestureRecognizer recognizer(io, 50ms, 200ms, true, record());
+
+    recognizer.edge(false, at(0ms));
+    recognizer.edge(true, at(10ms));
+    recognizer.edge(false, at(20ms));
+    run(300ms);
+    ASSERT_EQ(1, gestures.size());
+    EXPECT_EQ(Gesture::longPress, gestures.back());
+}
+
+/** @brief Makes sure that durations come from the edge timestamps
+ */
+TEST_F(GestureTest, kernelTimestamps)
+{
+    GestureRecognizer recognizer(io, 500ms, 100ms, true, record());
+
+    // Released late according to the timestamps, before the timer ran
+    recognizer.edge(false, at(-1000ms));
+    recognizer.edge(true, at(-400ms));
+    ASSERT_EQ(1, gestures.size());
+    EXPECT_EQ(Gesture::longPress, gestures.back());
+
+    // Second press came in after the window, before the timer ran
+    recognizer.edge(false, at(-300ms));
+    recognizer.edge(true, at(-290ms));
+    recognizer.edge(false, at(-100ms));
+    ASSERT_EQ(2, gestures.size());
+    EXPECT_EQ(Gesture::shortPress, gestures.back());
+}
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "histogram.hpp"
+
+#include <array>
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+using namespace std::chrono_literals;
+
+/** @brief Makes sure that the buckets double from 1 ms up to the last one
+ */
+TEST(HistogramTest, bucket)
+{
+    EXPECT_EQ(histogram::bucket(-1ms, 8), 0U);
+    EXPECT_EQ(histogram::bucket(0ns, 8), 0U);
+    EXPECT_EQ(histogram::bucket(999us, 8), 0U);
+    EXPECT_EQ(histogram::bucket(1ms, 8), 1U);
+    EXPECT_EQ(histogram::bucket(2ms, 8), 2U);
+    EXPECT_EQ(histogram::bucket(3ms, 8), 2U);
+    EXPECT_EQ(histogram::bucket(63ms, 8), 6U);
+    EXPECT_EQ(histogram::bucket(64ms, 8), 7U);
+    EXPECT_EQ(histogram::bucket(1h, 8), 7U);
+}
+
+/** @brief Makes sure that the labels match the bucket bounds */
+TEST(HistogramTest, label)
+{
+    EXPECT_EQ(histogram::label(0, 8), "<1ms");
+    EXPECT_EQ(histogram::label(1, 8), "<2ms");
+    EXPECT_EQ(histogram::label(6, 8), "<64ms");
+    EXPECT_EQ(histogram::label(7, 8), ">=64ms");
+}
+
+/** @brief Makes sure that only the buckets with counts are formatted */
+TEST(HistogramTest, format)
+{
+    std::array<uint64_t, 4> counts{};
+    EXPECT_EQ(histogram::format(counts), "");
+
+    counts[0] = 120;
+    counts[2] = 2;
+    counts[3] = 1;
+    EXPECT_EQ(histogram::format(counts), "<1ms: 120, <4ms: 2, >=4ms: 1");
+}
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "line_profile.hpp"
+
+#include <time.h>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+
+TEST(LineProfile, sameNameSameLine)
+{
+    auto id = profile::addLine("GPIO Line A");
+    EXPECT_EQ(profile::addLine("GPIO Line A"), id);
+    EXPECT_NE(profile::addLine("GPIO Line B"), id);
+}
+
+TEST(LineProfile, blockedTimeGoesToRunningHandler)
+{
+    auto outer = profile::addLine("outer");
+    auto inner = profile::addLine("inner");
+
+    {
+        profile::Blocked idle;
+    }
+    {
+        profile::Handler cost(outer);
+        {
+            profile::Handler nested(inner);
+            profile::Blocked blocked;
+        }
+        profile::Blocked blocked;
+    }
+
+    EXPECT_EQ(profile::stats(outer).events, 1U);
+    EXPECT_EQ(profile::stats(inner).events, 1U);
+    EXPECT_GE(profile::stats(outer).totalNs, profile::stats(inner).totalNs);
+    EXPECT_LE(profile::stats(inner).blockedNs, profile::stats(inner).totalNs);
+    EXPECT_LE(profile::stats(outer).blockedNs, profile::stats(outer).totalNs);
+}
+
+TEST(LineProfile, nestedTimeIsChargedOnce)
+{
+    auto outer = profile::addLine("enclosing");
+    auto inner = profile::addLine("nested");
+
+    timespec start{};
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+    {
+        profile::Handler cost(outer);
+        profile::Handler nested(inner);
+        volatile uint64_t sum = 0;
+        for (int i = 0; i < 100000; i++)
+        {
+            sum = sum + i;
+        }
+    }
+    timespec end{};
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+    uint64_t spanNs = (end.tv_sec - start.tv_sec) * 1000000000ULL +
+                      end.tv_nsec - start.tv_nsec;
+
+    EXPECT_LE(profile::stats(outer).totalNs + profile::stats(inner).totalNs,
+              spanNs);
+}
+
+TEST(LineProfile, sameLineNestedIsOneEvent)
+{
+    auto line = profile::addLine("reentered");
+
+    {
+        profile::Handler cost(line);
+        profile::Handler nested(line);
+    }
+
+    EXPECT_EQ(profile::stats(line).events, 1U);
+}
+
+TEST(LineProfile, topSortsByTotalTime)
+{
+    auto cheap = profile::addLine("cheap");
+    auto costly = profile::addLine("costly");
+
+    profile::record(cheap, 1000);
+    profile::record(costly, 500000);
+    profile::record(costly, 250000);
+
+    auto text = profile::top(1);
+    EXPECT_EQ(text, "costly: 2 events, total 750 us, max 500 us, D-Bus 0 us\n");
+}
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "line_state.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+
+namespace
+{
+
+std::string tablePath()
+{
+    char dir[] = "/tmp/line_state_testXXXXXX";
+    EXPECT_NE(mkdtemp(dir), nullptr);
+    return std::string(dir) + "/line-state";
+}
+
+} // namespace
+
+TEST(LineState, readerSeesTheLines)
+{
+    /* Lines added before the table is opened are published by open() */
+    auto before = linestate::addLine("GPIO Line PS_PWROK");
+    auto path = tablePath();
+    ASSERT_EQ(linestate::open(path, CLOCK_MONOTONIC), 0);
+    auto after = linestate::addLine("GPIO Line POWER_BUTTON");
+    EXPECT_EQ(linestate::addLine("GPIO Line PS_PWROK"), before);
+
+    linestate::Reader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_EQ(reader.find("GPIO Line PS_PWROK"), before);
+    EXPECT_EQ(reader.find("GPIO Line POWER_BUTTON"), after);
+    EXPECT_FALSE(reader.find("GPIO Line RESET_BUTTON").has_value());
+
+    auto state = reader.read(after);
+    ASSERT_TRUE(state.has_value());
+    EXPECT_EQ(state->value, -1);
+    EXPECT_EQ(state->edges, 0U);
+
+    std::filesystem::remove_all(std::filesystem::path(path).parent_path());
+}
+
+TEST(LineState, edgesAreCounted)
+{
+    auto path = tablePath();
+    ASSERT_EQ(linestate::open(path, CLOCK_MONOTONIC), 0);
+    auto line = linestate::addLine("GPIO Line PS_PWROK");
+
+    linestate::Reader reader;
+    ASSERT_TRUE(reader.open(path));
+
+    linestate::setValue(line, 0);
+    EXPECT_EQ(reader.read(line)->value, 0);
+
+    linestate::edge(line, true, {2, 500});
+    linestate::edge(line, false, {3, 0});
+    auto state = reader.read(line);
+    ASSERT_TRUE(state.has_value());
+    EXPECT_EQ(state->value, 0);
+    EXPECT_EQ(state->edges, 2U);
+    EXPECT_EQ(state->lastEdgeNs, 3000000000U);
+
+    std::filesystem::remove_all(std::filesystem::path(path).parent_path());
+}
+
+TEST(LineState, otherFilesAreRejected)
+{
+    auto path = tablePath();
+    ASSERT_EQ(linestate::open(path, CLOCK_MONOTONIC), 0);
+
+    std::ofstream(path + ".short") << "GPSL";
+
+    linestate::Reader missing;
+    EXPECT_FALSE(missing.open(path + ".missing"));
+    linestate::Reader truncated;
+    EXPECT_FALSE(truncated.open(path + ".short"));
+
+    std::filesystem::remove_all(std::filesystem::path(path).parent_path());
+}
+
+TEST(LineState, replacedTableIsStale)
+{
+    auto path = tablePath();
+    ASSERT_EQ(linestate::open(path, CLOCK_MONOTONIC), 0);
+    auto line = linestate::addLine("GPIO Line PS_PWROK");
+
+    linestate::Reader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_FALSE(reader.stale());
+    EXPECT_TRUE(reader.read(line).has_value());
+
+    /* The old mapping stays readable but is retired, a new one sees the
+     * updates */
+    ASSERT_EQ(linestate::open(path, CLOCK_MONOTONIC), 0);
+    EXPECT_TRUE(reader.stale());
+    EXPECT_FALSE(reader.read(line).has_value());
+
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_FALSE(reader.stale());
+    linestate::edge(line, true, {1, 0});
+    EXPECT_EQ(reader.read(line)->edges, 1U);
+
+    /* Only the table file is left in the directory */
+    auto dir = std::filesystem::path(path).parent_path();
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(dir),
+                            std::filesystem::directory_iterator()),
+              1);
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(LineState, unknownSlotsAreNotRead)
+{
+    linestate::Reader closed;
+    EXPECT_TRUE(closed.stale());
+    EXPECT_FALSE(closed.find("GPIO Line PS_PWROK").has_value());
+    EXPECT_FALSE(closed.read(0).has_value());
+
+    auto path = tablePath();
+    ASSERT_EQ(linestate::open(path, CLOCK_MONOTONIC), 0);
+    auto line = linestate::addLine("GPIO Line PS_PWROK");
+
+    linestate::Reader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_TRUE(reader.read(line).has_value());
+    EXPECT_FALSE(reader.read(linestate::maxLines).has_value());
+    EXPECT_FALSE(reader.read(linestate::maxLines - 1).has_value());
+
+    std::filesystem::remove_all(std::filesystem::path(path).parent_path());
+}
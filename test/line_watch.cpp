@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "line_watch.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+
+/** @brief Makes sure that the direction is always described */
+TEST(LineWatchTest, describeDirection)
+{
+    EXPECT_EQ(LineInfoWatcher::describe(0), "input");
+    EXPECT_EQ(LineInfoWatcher::describe(GPIO_V2_LINE_FLAG_INPUT), "input");
+    EXPECT_EQ(LineInfoWatcher::describe(GPIO_V2_LINE_FLAG_OUTPUT), "output");
+}
+
+/** @brief Makes sure that the active level, bias and drive are described
+ *         in order
+ */
+TEST(LineWatchTest, describeFlags)
+{
+    EXPECT_EQ(LineInfoWatcher::describe(GPIO_V2_LINE_FLAG_INPUT |
+                                        GPIO_V2_LINE_FLAG_ACTIVE_LOW |
+                                        GPIO_V2_LINE_FLAG_BIAS_PULL_UP),
+              "input active-low pull-up");
+    EXPECT_EQ(LineInfoWatcher::describe(GPIO_V2_LINE_FLAG_OUTPUT |
+                                        GPIO_V2_LINE_FLAG_OPEN_DRAIN),
+              "output open-drain");
+    EXPECT_EQ(LineInfoWatcher::describe(GPIO_V2_LINE_FLAG_OUTPUT |
+                                        GPIO_V2_LINE_FLAG_BIAS_DISABLED |
+                                        GPIO_V2_LINE_FLAG_OPEN_SOURCE),
+              "output bias-disabled open-source");
+    EXPECT_EQ(LineInfoWatcher::describe(GPIO_V2_LINE_FLAG_INPUT |
+                                        GPIO_V2_LINE_FLAG_BIAS_PULL_DOWN),
+              "input pull-down");
+}
+
+/** @brief Makes sure that only one bias is described, as the kernel sets
+ *         one at most
+ */
+TEST(LineWatchTest, describeOneBias)
+{
+    EXPECT_EQ(LineInfoWatcher::describe(GPIO_V2_LINE_FLAG_BIAS_PULL_UP |
+                                        GPIO_V2_LINE_FLAG_BIAS_PULL_DOWN),
+              "input pull-up");
+}
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "loop_lag.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+using namespace std::chrono_literals;
+
+TEST(LoopLag, bucketsDoubleFromOneMillisecond)
+{
+    EXPECT_EQ(looplag::bucket(0us), 0U);
+    EXPECT_EQ(looplag::bucket(999us), 0U);
+    EXPECT_EQ(looplag::bucket(1ms), 1U);
+    EXPECT_EQ(looplag::bucket(3ms), 2U);
+    EXPECT_EQ(looplag::bucket(4ms), 3U);
+    EXPECT_EQ(looplag::bucket(1023ms), looplag::buckets - 2);
+    EXPECT_EQ(looplag::bucket(1024ms), looplag::buckets - 1);
+    EXPECT_EQ(looplag::bucket(1h), looplag::buckets - 1);
+}
+
+TEST(LoopLag, tickRecordsLag)
+{
+    auto before = looplag::histogram();
+    auto due = looplag::Clock::now();
+
+    looplag::tick(due, due + 5ms);
+    /* A timer running early counts as no lag */
+    looplag::tick(due, due - 1ms);
+
+    auto after = looplag::histogram();
+    EXPECT_EQ(after[looplag::bucket(5ms)], before[looplag::bucket(5ms)] + 1);
+    EXPECT_EQ(after[0], before[0] + 1);
+}
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "output.hpp"
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+using namespace std::chrono_literals;
+
+/** @brief Makes sure that the actions of the config file are parsed */
+TEST(OutputTest, parseAction)
+{
+    EXPECT_EQ(OutputLine::parseAction("Set"), OutputLine::Action::set);
+    EXPECT_EQ(OutputLine::parseAction("Clear"), OutputLine::Action::clear);
+    EXPECT_EQ(OutputLine::parseAction("Mirror"), OutputLine::Action::mirror);
+    EXPECT_EQ(OutputLine::parseAction("Pulse"), OutputLine::Action::pulse);
+    EXPECT_FALSE(OutputLine::parseAction("pulse").has_value());
+    EXPECT_FALSE(OutputLine::parseAction("").has_value());
+}
+
+/** @brief Makes sure that the latency is measured across a second
+ *         boundary and summed up
+ */
+TEST(OutputTest, latency)
+{
+    OutputLine::Stats stats;
+    EXPECT_EQ(stats.mean(), 0ns);
+
+    EXPECT_EQ(stats.add({10, 999'990'000}, {11, 10'000}), 20us);
+    EXPECT_EQ(stats.add({12, 0}, {12, 40'000}), 40us);
+    EXPECT_EQ(stats.add({13, 500}, {13, 30'500}), 30us);
+
+    EXPECT_EQ(stats.actions, 3U);
+    EXPECT_EQ(stats.total, 90us);
+    EXPECT_EQ(stats.mean(), 30us);
+    EXPECT_EQ(stats.max, 40us);
+}
+
+/** @brief Makes sure that an output starts without actions */
+TEST(OutputTest, noActions)
+{
+    boost::asio::io_context io;
+    OutputLine output(io, "GPIO Line led-identify");
+
+    EXPECT_EQ(output.statistics().actions, 0U);
+    EXPECT_EQ(output.statistics().mean(), 0ns);
+}
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "pulse_meter.hpp"
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+using namespace std::chrono_literals;
+
+/** @brief Feeds a square wave of the given period and high time
+ *
+ *  @return time of the last edge
+ */
+PulseMeter::Clock::time_point square(PulseMeter& meter,
+                                     PulseMeter::Clock::time_point start,
+                                     std::chrono::microseconds period,
+                                     std::chrono::microseconds high,
+                                     int cycles)
+{
+    auto time = start;
+    for (int i = 0; i < cycles; i++)
+    {
+        meter.edge(true, time);
+        meter.edge(false, time + high);
+        time += period;
+    }
+    return time - period + high;
+}
+
+/** @brief Makes sure that frequency and duty cycle follow a square wave
+ */
+TEST(PulseMeterTest, squareWave)
+{
+    PulseMeter meter(1000ms, 4096);
+    auto start = PulseMeter::Clock::time_point(100s);
+
+    // 100 Hz, 25 % duty cycle, for two windows
+    square(meter, start, 10ms, 2500us, 200);
+    auto result = meter.measure(start + 2s);
+
+    EXPECT_EQ(200, result.edges);
+    EXPECT_NEAR(100.0, result.frequency, 1.0);
+    EXPECT_NEAR(25.0, result.dutyCycle, 0.5);
+    EXPECT_EQ(2500, result.minPulseWidth);
+    EXPECT_EQ(2500, result.maxPulseWidth);
+}
+
+/** @brief Makes sure that min and max pulse widths are tracked
+ */
+TEST(PulseMeterTest, pulseWidths)
+{
+    PulseMeter meter(1000ms, 64);
+    auto start = PulseMeter::Clock::time_point(100s);
+
+    meter.edge(false, start);
+    meter.edge(true, start + 100ms);
+    meter.edge(false, start + 110ms);
+    meter.edge(true, start + 200ms);
+    meter.edge(false, start + 250ms);
+    auto result = meter.measure(start + 300ms);
+
+    EXPECT_EQ(5, result.edges);
+    EXPECT_EQ(10000, result.minPulseWidth);
+    EXPECT_EQ(50000, result.maxPulseWidth);
+}
+
+/** @brief Makes sure that old edges leave the window and the level stays
+ */
+TEST(PulseMeterTest, windowExpires)
+{
+    PulseMeter meter(100ms, 64);
+    auto start = PulseMeter::Clock::time_point(100s);
+
+    meter.edge(false, start);
+    meter.edge(true, start + 10ms);
+    auto result = meter.measure(start + 1s);
+
+    EXPECT_EQ(0, result.edges);
+    EXPECT_EQ(0.0, result.frequency);
+    EXPECT_EQ(100.0, result.dutyCycle);
+}
+
+/** @brief Makes sure that a full ring drops the oldest edges
+ */
+TEST(PulseMeterTest, boundedRing)
+{
+    PulseMeter meter(1000ms, 16);
+    auto start = PulseMeter::Clock::time_point(100s);
+
+    // 1 kHz, 50 % duty cycle
+    auto last = square(meter, start, 1ms, 500us, 500);
+    auto result = meter.measure(last);
+
+    EXPECT_EQ(16, result.edges);
+    EXPECT_NEAR(1000.0, result.frequency, 100.0);
+    EXPECT_NEAR(50.0, result.dutyCycle, 5.0);
+}
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "ratelimit.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+using namespace std::chrono_literals;
+
+constexpr auto siteA = "{GPIO} Asserted";
+constexpr auto siteB = "{GPIO} Deasserted";
+
+/** @brief Makes sure that a burst is allowed and the rest is suppressed
+ */
+TEST(RateLimitTest, burstThenSuppress)
+{
+    ratelimit::Limiter limiter("GPIO Line TEST", {1.0, 3});
+    auto now = ratelimit::Clock::now();
+
+    EXPECT_TRUE(limiter.allow(siteA, now));
+    EXPECT_TRUE(limiter.allow(siteA, now));
+    EXPECT_TRUE(limiter.allow(siteA, now));
+    EXPECT_FALSE(limiter.allow(siteA, now));
+    EXPECT_FALSE(limiter.allow(siteA, now));
+
+    EXPECT_EQ(2, limiter.suppressed(siteA));
+}
+
+/** @brief Makes sure that tokens are refilled at the configured rate
+ */
+TEST(RateLimitTest, refill)
+{
+    ratelimit::Limiter limiter("GPIO Line TEST", {2.0, 1});
+    auto now = ratelimit::Clock::now();
+
+    EXPECT_TRUE(limiter.allow(siteA, now));
+    EXPECT_FALSE(limiter.allow(siteA, now + 100ms));
+    EXPECT_TRUE(limiter.allow(siteA, now + 600ms));
+
+    // The bucket never holds more than the burst
+    EXPECT_TRUE(limiter.allow(siteA, now + 10s));
+    EXPECT_FALSE(limiter.allow(siteA, now + 10s));
+}
+
+/** @brief Makes sure that message sites have their own bucket
+ */
+TEST(RateLimitTest, sitesAreIndependent)
+{
+    ratelimit::Limiter limiter("GPIO Line TEST", {1.0, 1});
+    auto now = ratelimit::Clock::now();
+
+    EXPECT_TRUE(limiter.allow(siteA, now));
+    EXPECT_FALSE(limiter.allow(siteA, now));
+    EXPECT_TRUE(limiter.allow(siteB, now));
+
+    EXPECT_EQ(1, limiter.suppressed(siteA));
+    EXPECT_EQ(0, limiter.suppressed(siteB));
+}
+
+/** @brief Makes sure that a flush resets the suppressed counts
+ */
+TEST(RateLimitTest, flushResetsCount)
+{
+    ratelimit::Limiter limiter("GPIO Line TEST", {1.0, 1});
+    auto now = ratelimit::Clock::now();
+
+    limiter.allow(siteA, now);
+    limiter.allow(siteA, now);
+    EXPECT_EQ(1, limiter.suppressed(siteA));
+
+    limiter.flush();
+    EXPECT_EQ(0, limiter.suppressed(siteA));
+}
+
+/** @brief Makes sure that the limiter of a line is shared
+ */
+TEST(RateLimitTest, limiterPerLine)
+{
+    auto& first = ratelimit::get("GPIO Line SHARED", {1.0, 1});
+    auto& second = ratelimit::get("GPIO Line SHARED");
+    auto& other = ratelimit::get("GPIO Line OTHER");
+
+    EXPECT_EQ(&first, &second);
+    EXPECT_NE(&first, &other);
+}
+
+/** @brief Makes sure that a rate limited message takes a token of its
+ *         format string
+ */
+TEST(RateLimitTest, logTakesToken)
+{
+    ratelimit::Limiter limiter("GPIO Line TEST", {1.0, 1});
+
+    ratelimit::info(limiter, siteA, "GPIO", "GPIO Line TEST");
+    ratelimit::info(limiter, siteA, "GPIO", "GPIO Line TEST");
+
+    EXPECT_EQ(1, limiter.suppressed(siteA));
+    EXPECT_EQ(0, limiter.suppressed(siteB));
+}
+
+/** @brief Makes sure that the limits of a config file entry are parsed
+ */
+TEST(RateLimitTest, parseLimits)
+{
+    auto defaults = ratelimit::parse(nlohmann::json::object());
+    EXPECT_EQ(ratelimit::config().defaults.rate, defaults.rate);
+    EXPECT_EQ(ratelimit::config().defaults.burst, defaults.burst);
+
+    auto limits = ratelimit::parse(
+        nlohmann::json::parse(R"({"LogRateLimit": {"Rate": 0.5, "Burst": 2}})"));
+    EXPECT_EQ(0.5, limits.rate);
+    EXPECT_EQ(2, limits.burst);
+}
+
+/** @brief Makes sure that limits letting no message through are rejected
+ */
+TEST(RateLimitTest, parseRejectsInvalid)
+{
+    for (const auto* limits : {R"({"Rate": 0})", R"({"Rate": -1})",
+                               R"({"Rate": "fast"})", R"({"Burst": 0})",
+                               R"({"Burst": -1})", R"({"Burst": 1.5})",
+                               R"({"Burst": 4294967296})", R"(5)"})
+    {
+        nlohmann::json obj{{"LogRateLimit", nlohmann::json::parse(limits)}};
+        EXPECT_THROW(ratelimit::parse(obj), std::invalid_argument) << limits;
+    }
+}
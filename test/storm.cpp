@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "storm.hpp"
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+using namespace std::chrono_literals;
+
+/** @brief Makes sure that a line is only switched to polling when its
+ *         edges exceed the rate within one window
+ */
+TEST(StormDetectorTest, rate)
+{
+    StormDetector detector({100, 20ms, 1000ms});
+    auto now = StormDetector::Clock::time_point(100s);
+
+    // 100 edges per second for three seconds is not a storm
+    for (int i = 0; i < 300; i++)
+    {
+        EXPECT_FALSE(detector.edges(1, now + i * 10ms));
+    }
+    EXPECT_FALSE(detector.storming());
+
+    // 16 edges per wakeup cross the rate within the next window
+    now += 3s;
+    bool started = false;
+    for (int i = 0; i < 7 && !started; i++)
+    {
+        started = detector.edges(16, now + i * 1ms);
+    }
+    EXPECT_TRUE(started);
+    EXPECT_TRUE(detector.storming());
+    EXPECT_EQ(1, detector.storms());
+
+    // Edges read while storming do not start another storm
+    EXPECT_FALSE(detector.edges(16, now + 10ms));
+    EXPECT_EQ(1, detector.storms());
+}
+
+/** @brief Makes sure that edge events are only requested again after the
+ *         line was quiet for the quiet time
+ */
+TEST(StormDetectorTest, quiet)
+{
+    StormDetector detector({10, 20ms, 1000ms});
+    auto now = StormDetector::Clock::time_point(100s);
+
+    ASSERT_TRUE(detector.edges(11, now));
+
+    // A change restarts the quiet time
+    EXPECT_FALSE(detector.sample(false, now + 900ms));
+    EXPECT_FALSE(detector.sample(true, now + 920ms));
+    EXPECT_FALSE(detector.sample(false, now + 1900ms));
+    EXPECT_TRUE(detector.sample(false, now + 1920ms));
+    EXPECT_FALSE(detector.storming());
+
+    // The edges of the previous storm are forgotten
+    EXPECT_FALSE(detector.edges(10, now + 1930ms));
+    EXPECT_TRUE(detector.edges(1, now + 1940ms));
+    EXPECT_EQ(2, detector.storms());
+}
+
+/** @brief Makes sure that a rate of 0 disables the detection */
+TEST(StormDetectorTest, disabled)
+{
+    StormDetector detector({0, 20ms, 1000ms});
+    auto now = StormDetector::Clock::time_point(100s);
+
+    EXPECT_FALSE(detector.edges(100000, now));
+    EXPECT_FALSE(detector.storming());
+    EXPECT_FALSE(detector.sample(false, now + 2s));
+}
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "timeline.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+
+namespace
+{
+
+timespec at(long us)
+{
+    return {us / 1000000, (us % 1000000) * 1000};
+}
+
+} // namespace
+
+TEST(Timeline, keepsTheLatestEdges)
+{
+    timeline::open(3);
+    auto line = timeline::addLine("PS_PWROK");
+    EXPECT_EQ(timeline::addLine("PS_PWROK"), line);
+
+    for (long i = 1; i <= 6; i++)
+    {
+        timeline::record(line, i % 2, at(i));
+    }
+
+    /* The capacity is rounded up to 4 */
+    ASSERT_EQ(timeline::size(), 4U);
+    EXPECT_EQ(timeline::at(0).timestampNs, 3000U);
+    EXPECT_EQ(timeline::at(3).timestampNs, 6000U);
+    EXPECT_FALSE(timeline::at(3).rising);
+}
+
+TEST(Timeline, frozenRingIsNotWritten)
+{
+    timeline::open(4);
+    auto line = timeline::addLine("CPU_PWRGD");
+
+    timeline::record(line, true, at(1));
+    timeline::freeze();
+    timeline::record(line, false, at(2));
+    EXPECT_EQ(timeline::size(), 1U);
+
+    timeline::thaw();
+    timeline::record(line, false, at(3));
+    EXPECT_EQ(timeline::size(), 2U);
+}
+
+TEST(Timeline, chromeTraceHasACounterPerEdge)
+{
+    timeline::open(8);
+    auto pwrok = timeline::addLine("PS_PWROK");
+    auto reset = timeline::addLine("RESET");
+
+    timeline::record(pwrok, true, at(10));
+    timeline::record(reset, false, at(25));
+
+    auto trace = nlohmann::json::parse(timeline::chromeTrace());
+    const auto& events = trace["traceEvents"];
+    ASSERT_EQ(events.size(), 2U);
+    EXPECT_EQ(events[0]["name"], "PS_PWROK");
+    EXPECT_EQ(events[0]["ph"], "C");
+    EXPECT_EQ(events[0]["ts"], 10.0);
+    EXPECT_EQ(events[0]["args"]["level"], 1);
+    EXPECT_EQ(events[1]["name"], "RESET");
+    EXPECT_EQ(events[1]["args"]["level"], 0);
+}
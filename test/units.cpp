@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "units.hpp"
+
+#include <time.h>
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::gpio;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+/** @brief Returns the CLOCK_MONOTONIC time some time ago, in ns */
+uint64_t ago(std::chrono::nanoseconds duration)
+{
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    auto now = std::chrono::seconds(ts.tv_sec) +
+               std::chrono::nanoseconds(ts.tv_nsec);
+    return (now - duration).count();
+}
+
+} // namespace
+
+/** @brief Makes sure that the start policies of the config file are parsed
+ */
+TEST(UnitsTest, parseStartPolicy)
+{
+    EXPECT_EQ(parseStartPolicy("Always"), StartPolicy::always);
+    EXPECT_EQ(parseStartPolicy("SkipIfQueued"), StartPolicy::skipQueued);
+    EXPECT_EQ(parseStartPolicy("SkipIfActive"), StartPolicy::skipActive);
+    EXPECT_FALSE(parseStartPolicy("skipifqueued").has_value());
+    EXPECT_FALSE(parseStartPolicy("").has_value());
+}
+
+/** @brief Makes sure that Always never skips a start */
+TEST(UnitsTest, alwaysStarts)
+{
+    EXPECT_FALSE(skipStart(StartPolicy::always, "inactive", false));
+    EXPECT_FALSE(skipStart(StartPolicy::always, "activating", true));
+    EXPECT_FALSE(skipStart(StartPolicy::always, "active", false));
+}
+
+/** @brief Makes sure that SkipIfQueued only skips while a start is queued
+ *         or running
+ */
+TEST(UnitsTest, skipIfQueued)
+{
+    EXPECT_FALSE(skipStart(StartPolicy::skipQueued, "inactive", false));
+    EXPECT_TRUE(skipStart(StartPolicy::skipQueued, "inactive", true));
+    EXPECT_TRUE(skipStart(StartPolicy::skipQueued, "activating", false));
+    EXPECT_FALSE(skipStart(StartPolicy::skipQueued, "active", false));
+    EXPECT_FALSE(skipStart(StartPolicy::skipQueued, "failed", false));
+}
+
+/** @brief Makes sure that SkipIfActive also skips while the unit is active
+ */
+TEST(UnitsTest, skipIfActive)
+{
+    EXPECT_FALSE(skipStart(StartPolicy::skipActive, "inactive", false));
+    EXPECT_TRUE(skipStart(StartPolicy::skipActive, "inactive", true));
+    EXPECT_TRUE(skipStart(StartPolicy::skipActive, "activating", false));
+    EXPECT_TRUE(skipStart(StartPolicy::skipActive, "active", false));
+    EXPECT_TRUE(skipStart(StartPolicy::skipActive, "reloading", false));
+    EXPECT_FALSE(skipStart(StartPolicy::skipActive, "deactivating", false));
+    EXPECT_FALSE(skipStart(StartPolicy::skipActive, "failed", false));
+}
+
+/** @brief Makes sure that the latency buckets double up to 16 s */
+TEST(UnitsTest, latencyBucket)
+{
+    EXPECT_EQ(latencyBucket(500us), 0U);
+    EXPECT_EQ(latencyBucket(1ms), 1U);
+    EXPECT_EQ(latencyBucket(5ms), 3U);
+    EXPECT_EQ(latencyBucket(16383ms), latencyBuckets - 2);
+    EXPECT_EQ(latencyBucket(16384ms), latencyBuckets - 1);
+    EXPECT_EQ(latencyBucket(1h), latencyBuckets - 1);
+}
+
+/** @brief Makes sure that a removed job is counted once, with its latency
+ *         and result, and that other jobs are ignored
+ */
+TEST(UnitsTest, pendingJobs)
+{
+    auto& limiter = ratelimit::get("GPIO Line PS_PWROK");
+    auto pending = pendingJobCount();
+
+    jobQueued("/org/freedesktop/systemd1/job/1", "test-slow.service",
+              ago(100s), limiter);
+    jobQueued("/org/freedesktop/systemd1/job/2", "test-slow.service",
+              ago(20s), limiter);
+    EXPECT_EQ(pendingJobCount(), pending + 2);
+
+    jobRemoved("/org/freedesktop/systemd1/job/1", "test-slow.service",
+               "done");
+    jobRemoved("/org/freedesktop/systemd1/job/2", "test-slow.service",
+               "failed");
+    EXPECT_EQ(pendingJobCount(), pending);
+
+    /* Removed twice, or started by another client */
+    jobRemoved("/org/freedesktop/systemd1/job/1", "test-slow.service",
+               "done");
+    jobRemoved("/org/freedesktop/systemd1/job/3", "test-slow.service",
+               "done");
+
+    const auto& stats = actionStats().at("test-slow.service");
+    EXPECT_EQ(stats.histogram[latencyBuckets - 1], 2U);
+    EXPECT_EQ(stats.results.at("done"), 1U);
+    EXPECT_EQ(stats.results.at("failed"), 1U);
+    EXPECT_GE(stats.max, 100s);
+    EXPECT_FALSE(actionStats().contains("test-other.service"));
+}
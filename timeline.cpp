@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "timeline.hpp"
+
+#include <nlohmann/json.hpp>
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <vector>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace timeline
+{
+
+namespace
+{
+
+std::vector<Record> ring;
+
+/** @brief Number of edges recorded, the next one goes to head & mask */
+uint64_t head = 0;
+uint64_t mask = 0;
+
+bool stopped = false;
+
+std::vector<std::string> lineNames;
+
+} // namespace
+
+void open(size_t capacity)
+{
+    ring.assign(std::bit_ceil(std::max<size_t>(capacity, 1)), Record{});
+    mask = ring.size() - 1;
+    head = 0;
+}
+
+uint32_t addLine(const std::string& name)
+{
+    auto it = std::find(lineNames.begin(), lineNames.end(), name);
+    if (it != lineNames.end())
+    {
+        return it - lineNames.begin();
+    }
+
+    lineNames.push_back(name);
+    return lineNames.size() - 1;
+}
+
+void record(uint32_t lineId, bool rising, const timespec& ts)
+{
+    if (ring.empty() || stopped)
+    {
+        return;
+    }
+
+    ring[head & mask] = {static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL +
+                             static_cast<uint64_t>(ts.tv_nsec),
+                         lineId, rising};
+    head++;
+}
+
+void freeze()
+{
+    stopped = true;
+}
+
+void thaw()
+{
+    stopped = false;
+}
+
+bool frozen()
+{
+    return stopped;
+}
+
+size_t size()
+{
+    return std::min<uint64_t>(head, ring.size());
+}
+
+const Record& at(size_t index)
+{
+    return ring[(head - size() + index) & mask];
+}
+
+std::string chromeTrace()
+{
+    auto events = nlohmann::json::array();
+
+    for (size_t i = 0; i < size(); i++)
+    {
+        const auto& rec = at(i);
+        const auto& name = rec.lineId < lineNames.size()
+                               ? lineNames[rec.lineId]
+                               : std::to_string(rec.lineId);
+
+        /* Trace timestamps are in microseconds */
+        events.push_back({{"name", name},
+                          {"ph", "C"},
+                          {"ts", rec.timestampNs / 1000.0},
+                          {"pid", 1},
+                          {"args", {{"level", rec.rising ? 1 : 0}}}});
+    }
+
+    nlohmann::json trace = {{"traceEvents", std::move(events)},
+                            {"displayTimeUnit", "ns"}};
+    return trace.dump();
+}
+
+std::string dump(const std::string& dir)
+{
+    bool wasFrozen = stopped;
+    freeze();
+
+    timespec now{};
+    clock_gettime(CLOCK_REALTIME, &now);
+    auto path = dir + "/timeline-" + std::to_string(now.tv_sec) + ".json";
+
+    std::ofstream file(path);
+    file << chromeTrace();
+    file.close();
+
+    stopped = wasFrozen;
+
+    if (!file)
+    {
+        lg2::error("Failed to write the edge timeline to {PATH}", "PATH",
+                   path);
+        return {};
+    }
+
+    lg2::info("Wrote {COUNT} edges of the timeline to {PATH}", "COUNT",
+              size(), "PATH", path);
+    return path;
+}
+
+} // namespace timeline
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include <time.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace phosphor
+{
+namespace gpio
+{
+namespace timeline
+{
+
+/** @brief Edges kept by default */
+constexpr size_t defaultCapacity = 4096;
+
+/** @brief Recorded edge */
+struct Record
+{
+    /** @brief CLOCK_MONOTONIC kernel timestamp of the edge */
+    uint64_t timestampNs;
+    uint32_t lineId;
+    bool rising;
+};
+
+/** @brief Allocates the ring, until then record() does nothing.
+ *
+ *  The ring has a fixed size, rounded up to a power of two, and is written
+ *  without locks or allocations: every edge is handled on the thread of
+ *  the event loop.
+ *
+ *  @param[in] capacity - number of edges kept
+ */
+void open(size_t capacity = defaultCapacity);
+
+/** @brief Returns the id of a line, the same for the same name */
+uint32_t addLine(const std::string& name);
+
+/** @brief Records an edge, unless the ring is frozen
+ *
+ *  @param[in] lineId - id returned by addLine()
+ *  @param[in] rising - whether the edge is rising
+ *  @param[in] ts     - kernel timestamp of the edge
+ */
+void record(uint32_t lineId, bool rising, const timespec& ts);
+
+/** @brief Stops recording, the ring keeps the edges up to now */
+void freeze();
+
+/** @brief Resumes recording */
+void thaw();
+
+/** @brief Returns whether recording is stopped */
+bool frozen();
+
+/** @brief Returns the number of edges in the ring */
+size_t size();
+
+/** @brief Returns an edge of the ring, 0 being the oldest */
+const Record& at(size_t index);
+
+/** @brief Returns the ring as Chrome trace event JSON.
+ *
+ *  Every line is a counter track stepping between 0 and 1, so the edges of
+ *  all lines show on one timeline in Perfetto or chrome://tracing.
+ */
+std::string chromeTrace();
+
+/** @brief Freezes the ring, writes its trace to a new file and thaws it
+ *
+ *  @param[in] dir - directory of the trace file
+ *
+ *  @return the path of the file, empty on failure
+ */
+std::string dump(const std::string& dir);
+
+} // namespace timeline
+} // namespace gpio
+} // namespace phosphor
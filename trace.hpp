@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+/** @file
+ *  @brief USDT tracepoints of the GPIO event pipeline.
+ *
+ *  With the usdt meson option the probes are emitted through sys/sdt.h
+ *  under the phosphor_gpio provider, each one a nop until perf or bpftrace
+ *  attaches to it. Otherwise GPIO_TRACE expands to nothing and its
+ *  arguments are not evaluated.
+ *
+ *  Probes and their arguments:
+ *  - event_read: line, rising (1) or falling (0), kernel timestamp in ns
+ *  - event_batch: line, number of events read on one wakeup
+ *  - event_filtered: line, value of a read not handled as an edge
+ *  - action_start: unit
+ *  - action_end: unit, 0 or negative errno
+ *  - inventory_update: inventory path, present
+ *  - inventory_ack: inventory path, 0 or negative errno
+ *  - output_set: output line, value written, edge to write latency in ns
+ */
+
+#ifdef GPIO_USDT
+
+#include <sys/sdt.h>
+
+#define GPIO_TRACE(name, ...) STAP_PROBEV(phosphor_gpio, name, __VA_ARGS__)
+
+#else
+
+#define GPIO_TRACE(name, ...)                                                  \
+    do                                                                         \
+    {                                                                          \
+    } while (false)
+
+#endif
+
+#include <time.h>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @brief Returns a timespec as nanoseconds for the probes */
+inline unsigned long long traceNs(const struct timespec& ts)
+{
+    return static_cast<unsigned long long>(ts.tv_sec) * 1000000000ULL +
+           static_cast<unsigned long long>(ts.tv_nsec);
+}
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,372 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#include "units.hpp"
+
+#include "histogram.hpp"
+#include "line_profile.hpp"
+#include "trace.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/bus/match.hpp>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <variant>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/* systemd service to kick start a target. */
+constexpr auto SYSTEMD_SERVICE = "org.freedesktop.systemd1";
+constexpr auto SYSTEMD_ROOT = "/org/freedesktop/systemd1";
+constexpr auto SYSTEMD_INTERFACE = "org.freedesktop.systemd1.Manager";
+constexpr auto SYSTEMD_UNIT_INTERFACE = "org.freedesktop.systemd1.Unit";
+constexpr auto PROPERTY_INTERFACE = "org.freedesktop.DBus.Properties";
+
+namespace
+{
+
+/** @brief Cached state of a unit with a start policy */
+struct TrackedUnit
+{
+    StartPolicy policy = StartPolicy::always;
+    std::string activeState;
+
+    /** @brief Start jobs queued by startUnit() and not removed yet */
+    std::set<std::string> jobs;
+
+    uint64_t skipped = 0;
+    std::unique_ptr<sdbusplus::bus::match_t> stateMatch;
+};
+
+std::map<std::string, TrackedUnit> trackedUnits;
+
+/** @brief Start job queued by startUnit() */
+struct PendingJob
+{
+    std::string unit;
+
+    /** @brief CLOCK_MONOTONIC time the latency is measured from */
+    uint64_t startNs;
+
+    ratelimit::Limiter* logLimit;
+};
+
+/** @brief Pending start jobs by object path */
+std::map<std::string, PendingJob> pendingJobs;
+std::map<std::string, ActionStats> actions;
+std::chrono::milliseconds slowAction{1000};
+std::unique_ptr<sdbusplus::bus::match_t> jobRemovedMatch;
+
+uint64_t toNs(const timespec& ts)
+{
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL +
+           static_cast<uint64_t>(ts.tv_nsec);
+}
+
+uint64_t nowNs()
+{
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return toNs(ts);
+}
+
+} // namespace
+
+void jobQueued(const std::string& job, const std::string& unit,
+               uint64_t startNs, ratelimit::Limiter& logLimit)
+{
+    pendingJobs[job] = PendingJob{unit, startNs, &logLimit};
+}
+
+void jobRemoved(const std::string& job, const std::string& unit,
+                const std::string& result)
+{
+    if (auto it = trackedUnits.find(unit); it != trackedUnits.end())
+    {
+        it->second.jobs.erase(job);
+    }
+
+    auto pending = pendingJobs.find(job);
+    if (pending == pendingJobs.end())
+    {
+        return;
+    }
+    auto& logLimit = *pending->second.logLimit;
+    auto latency = std::chrono::microseconds(
+        (nowNs() - pending->second.startNs) / 1000);
+    pendingJobs.erase(pending);
+
+    auto& stats = actions[unit];
+    stats.histogram[latencyBucket(latency)]++;
+    stats.results[result]++;
+    stats.max = std::max(stats.max, latency);
+
+    if (result != "done")
+    {
+        ratelimit::warning(logLimit,
+                           "{UNIT} start job {RESULT} after {LATENCY_US} us",
+                           "UNIT", unit, "RESULT", result, "LATENCY_US",
+                           latency.count());
+    }
+    else if (latency >= slowAction)
+    {
+        ratelimit::info(logLimit,
+                        "{UNIT} started {LATENCY_US} us after the edge",
+                        "UNIT", unit, "LATENCY_US", latency.count());
+    }
+}
+
+const std::map<std::string, ActionStats>& actionStats()
+{
+    return actions;
+}
+
+size_t pendingJobCount()
+{
+    return pendingJobs.size();
+}
+
+int watchJobs(sdbusplus::asio::connection& conn,
+              std::chrono::milliseconds slow)
+{
+    slowAction = slow;
+    if (jobRemovedMatch)
+    {
+        return 0;
+    }
+
+    /* systemd only sends the job signals to subscribed clients */
+    try
+    {
+        auto method = conn.new_method_call(SYSTEMD_SERVICE, SYSTEMD_ROOT,
+                                           SYSTEMD_INTERFACE, "Subscribe");
+        conn.call_noreply(method);
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        lg2::error("Failed to subscribe to the systemd jobs: {ERROR}", "ERROR",
+                   e);
+        return -e.get_errno();
+    }
+
+    namespace rules = sdbusplus::bus::match::rules;
+    jobRemovedMatch = std::make_unique<sdbusplus::bus::match_t>(
+        conn,
+        rules::type::signal() + rules::member("JobRemoved") +
+            rules::path(SYSTEMD_ROOT) + rules::interface(SYSTEMD_INTERFACE),
+        [](sdbusplus::message_t& msg) {
+            uint32_t id = 0;
+            sdbusplus::object_path job;
+            std::string unit;
+            std::string result;
+            msg.read(id, job, unit, result);
+
+            jobRemoved(job.str, unit, result);
+        });
+
+    return 0;
+}
+
+size_t latencyBucket(std::chrono::microseconds latency)
+{
+    return histogram::bucket(latency, latencyBuckets);
+}
+
+void dumpActionStats()
+{
+    for (const auto& [unit, stats] : actions)
+    {
+        std::string results;
+        for (const auto& [result, count] : stats.results)
+        {
+            if (!results.empty())
+            {
+                results += ", ";
+            }
+            results += result + ": " + std::to_string(count);
+        }
+
+        lg2::info(
+            "{UNIT} start jobs {RESULTS}, max {MAX_US} us, histogram {HISTOGRAM}",
+            "UNIT", unit, "RESULTS", results, "MAX_US", stats.max.count(),
+            "HISTOGRAM", histogram::format(stats.histogram));
+    }
+}
+
+bool skipStart(StartPolicy policy, const std::string& activeState, bool queued)
+{
+    bool starting = queued || activeState == "activating";
+
+    switch (policy)
+    {
+        case StartPolicy::skipQueued:
+            return starting;
+        case StartPolicy::skipActive:
+            return starting || activeState == "active" ||
+                   activeState == "reloading";
+        case StartPolicy::always:
+        default:
+            return false;
+    }
+}
+
+std::optional<StartPolicy> parseStartPolicy(const std::string& name)
+{
+    if (name == "Always")
+    {
+        return StartPolicy::always;
+    }
+    if (name == "SkipIfQueued")
+    {
+        return StartPolicy::skipQueued;
+    }
+    if (name == "SkipIfActive")
+    {
+        return StartPolicy::skipActive;
+    }
+    return std::nullopt;
+}
+
+int trackUnit(sdbusplus::asio::connection& conn, const std::string& unit,
+              StartPolicy policy)
+{
+    sdbusplus::object_path path;
+    std::string activeState;
+
+    try
+    {
+        auto load = conn.new_method_call(SYSTEMD_SERVICE, SYSTEMD_ROOT,
+                                         SYSTEMD_INTERFACE, "LoadUnit");
+        load.append(unit);
+        path = conn.call(load).unpack<sdbusplus::object_path>();
+
+        auto get = conn.new_method_call(SYSTEMD_SERVICE, path.str.c_str(),
+                                        PROPERTY_INTERFACE, "Get");
+        get.append(SYSTEMD_UNIT_INTERFACE, "ActiveState");
+        activeState = std::get<std::string>(
+            conn.call(get).unpack<std::variant<std::string>>());
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        lg2::error(
+            "Failed to read the state of {UNIT}, always starting it: {ERROR}",
+            "UNIT", unit, "ERROR", e);
+        return -e.get_errno();
+    }
+
+    auto& tracked = trackedUnits[unit];
+    tracked.policy = policy;
+    tracked.activeState = std::move(activeState);
+    tracked.stateMatch = std::make_unique<sdbusplus::bus::match_t>(
+        conn,
+        sdbusplus::bus::match::rules::propertiesChanged(
+            path.str, SYSTEMD_UNIT_INTERFACE),
+        [&tracked](sdbusplus::message_t& msg) {
+            std::string interface;
+            /* Other property types are skipped */
+            std::map<std::string, std::variant<std::string>> changed;
+            msg.read(interface, changed);
+
+            auto it = changed.find("ActiveState");
+            if (it == changed.end())
+            {
+                return;
+            }
+            tracked.activeState = std::get<std::string>(it->second);
+
+            /* The start jobs are over, even if their removal was missed */
+            if (tracked.activeState == "active" ||
+                tracked.activeState == "failed")
+            {
+                tracked.jobs.clear();
+            }
+        });
+
+    return 0;
+}
+
+int startUnit(sdbusplus::bus_t& bus, const std::string& unit,
+              ratelimit::Limiter& logLimit,
+              const std::optional<timespec>& edge)
+{
+    auto startNs = edge ? toNs(*edge) : nowNs();
+
+    auto tracked = trackedUnits.find(unit);
+    if (tracked != trackedUnits.end() &&
+        skipStart(tracked->second.policy, tracked->second.activeState,
+                  !tracked->second.jobs.empty()))
+    {
+        auto& state = tracked->second;
+        state.skipped++;
+        ratelimit::info(
+            logLimit,
+            "Skipped starting {UNIT}, it is {STATE}, {COUNT} starts skipped",
+            "UNIT", unit, "STATE",
+            state.jobs.empty() ? state.activeState : "queued", "COUNT",
+            state.skipped);
+        return 0;
+    }
+
+    auto method = bus.new_method_call(SYSTEMD_SERVICE, SYSTEMD_ROOT,
+                                      SYSTEMD_INTERFACE, "StartUnit");
+    method.append(unit, "replace");
+
+    GPIO_TRACE(action_start, unit.c_str());
+    try
+    {
+        profile::Blocked blocked;
+        auto reply = bus.call(method);
+        auto job = reply.unpack<sdbusplus::object_path>().str;
+        if (tracked != trackedUnits.end())
+        {
+            tracked->second.jobs.insert(job);
+        }
+
+        /* Without the removal signal the job would never be forgotten */
+        if (jobRemovedMatch)
+        {
+            jobQueued(job, unit, startNs, logLimit);
+        }
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        GPIO_TRACE(action_end, unit.c_str(), -e.get_errno());
+        ratelimit::error(logLimit, "Failed to start {UNIT}: {ERROR}", "UNIT",
+                         unit, "ERROR", e);
+        return -e.get_errno();
+    }
+    GPIO_TRACE(action_end, unit.c_str(), 0);
+
+    return 0;
+}
+
+int startUnits(const std::vector<std::string>& units,
+               ratelimit::Limiter& logLimit,
+               const std::optional<timespec>& edge)
+{
+    if (units.empty())
+    {
+        return 0;
+    }
+
+    int result = 0;
+    auto bus = sdbusplus::bus::new_default();
+    for (const auto& unit : units)
+    {
+        if (auto rc = startUnit(bus, unit, logLimit, edge); rc < 0)
+        {
+            result = rc;
+        }
+    }
+
+    return result;
+}
+
+} // namespace gpio
+} // namespace phosphor
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+#pragma once
+
+#include "ratelimit.hpp"
+
+#include <time.h>
+
+#include <sdbusplus/asio/connection.hpp>
+#include <sdbusplus/bus.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace phosphor
+{
+namespace gpio
+{
+
+/** @brief Number of action latency histogram buckets, the first one below
+ *         1 ms and each next one twice as wide, up to 16 s and above
+ */
+constexpr size_t latencyBuckets = 16;
+
+/** @brief Start jobs of a unit, from the edge to the job removal */
+struct ActionStats
+{
+    std::array<uint64_t, latencyBuckets> histogram{};
+
+    /** @brief Jobs by result: "done", "failed", "canceled", "timeout",
+     *         "dependency" or "skipped"
+     */
+    std::map<std::string, uint64_t> results;
+
+    std::chrono::microseconds max{0};
+};
+
+/** @brief Watches the removal of the start jobs queued by startUnit(), to
+ *         record their latency and result. Called once before trackUnit().
+ *
+ *  @param[in] conn - connection receiving the systemd signals
+ *  @param[in] slow - latency of a job logged as slow
+ *
+ *  @return 0 on success and negative errno otherwise
+ */
+int watchJobs(sdbusplus::asio::connection& conn,
+              std::chrono::milliseconds slow);
+
+/** @brief Returns the histogram bucket of an action latency */
+size_t latencyBucket(std::chrono::microseconds latency);
+
+/** @brief Follows a start job queued by startUnit() until its removal
+ *
+ *  @param[in] job      - object path of the job
+ *  @param[in] unit     - unit started by the job
+ *  @param[in] startNs  - CLOCK_MONOTONIC time the latency is measured from
+ *  @param[in] logLimit - rate limiter of the job result messages
+ */
+void jobQueued(const std::string& job, const std::string& unit,
+               uint64_t startNs, ratelimit::Limiter& logLimit);
+
+/** @brief Records the latency and result of a removed start job, jobs not
+ *         followed by jobQueued() are ignored
+ *
+ *  @param[in] job    - object path of the job
+ *  @param[in] unit   - unit started by the job
+ *  @param[in] result - result of the JobRemoved signal, for example "done"
+ */
+void jobRemoved(const std::string& job, const std::string& unit,
+                const std::string& result);
+
+/** @brief Returns the start job statistics by unit */
+const std::map<std::string, ActionStats>& actionStats();
+
+/** @brief Returns the number of start jobs waiting for their removal */
+size_t pendingJobCount();
+
+/** @brief Logs the start job latency histogram and results of every unit */
+void dumpActionStats();
+
+/** @brief When the start of a unit is skipped */
+enum class StartPolicy
+{
+    /** @brief Always start the unit, replacing any queued job */
+    always,
+    /** @brief Skip while a start job of the unit is queued or running */
+    skipQueued,
+    /** @brief Skip also while the unit is active */
+    skipActive,
+};
+
+/** @brief Parses "Always", "SkipIfQueued" or "SkipIfActive" */
+std::optional<StartPolicy> parseStartPolicy(const std::string& name);
+
+/** @brief Returns whether a policy skips starting a unit now
+ *
+ *  @param[in] policy      - start policy of the unit
+ *  @param[in] activeState - ActiveState of the unit
+ *  @param[in] queued      - whether a start job of the unit is queued
+ */
+bool skipStart(StartPolicy policy, const std::string& activeState,
+               bool queued);
+
+/** @brief Applies a start policy to a unit.
+ *
+ *  The ActiveState of the unit and the start jobs queued by startUnit()
+ *  are cached from the systemd signals, so a start is skipped without
+ *  asking systemd. Needs watchJobs().
+ *
+ *  @param[in] conn   - connection receiving the systemd signals
+ *  @param[in] unit   - systemd unit
+ *  @param[in] policy - when starts of the unit are skipped
+ *
+ *  @return 0 on success and negative errno if the unit state could not be
+ *          read, the unit is always started then
+ */
+int trackUnit(sdbusplus::asio::connection& conn, const std::string& unit,
+              StartPolicy policy);
+
+/** @brief Starts a systemd unit, replacing any queued job for it, unless
+ *         the policy of the unit skips it.
+ *
+ *  @param[in] bus      - D-Bus bus object
+ *  @param[in] unit     - systemd unit to start
+ *  @param[in] logLimit - rate limiter of the failure message
+ *  @param[in] edge     - CLOCK_MONOTONIC time of the edge starting the
+ *                        unit, the job latency is measured from it
+ *
+ *  @return 0 on success and negative errno otherwise
+ */
+int startUnit(sdbusplus::bus_t& bus, const std::string& unit,
+              ratelimit::Limiter& logLimit,
+              const std::optional<timespec>& edge = std::nullopt);
+
+/** @brief Starts a list of systemd units.
+ *
+ *  @param[in] units    - systemd units to start, in order
+ *  @param[in] logLimit - rate limiter of the failure messages
+ *  @param[in] edge     - CLOCK_MONOTONIC time of the edge starting them
+ *
+ *  @return 0 on success and the error of the last failed unit otherwise
+ */
+int startUnits(const std::vector<std::string>& units,
+               ratelimit::Limiter& logLimit,
+               const std::optional<timespec>& edge = std::nullopt);
+
+} // namespace gpio
+} // namespace phosphor